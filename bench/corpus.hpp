@@ -0,0 +1,203 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace TOMLBench {
+	/// <summary>
+	/// Shape of a generated document.
+	/// </summary>
+	struct CorpusOptions {
+		/// <summary>
+		/// Approximate document size in bytes, generation stops at the first line past it.
+		/// </summary>
+		size_t targetBytes = 1 << 20;
+		/// <summary>
+		/// Number of [table] headers, entries are spread evenly between them.
+		/// </summary>
+		int tables = 64;
+		/// <summary>
+		/// Key length in characters, including the numeric suffix that keeps keys unique.
+		/// </summary>
+		int keyLength = 12;
+		/// <summary>
+		/// Relative weights of the value kinds: string, integer, decimal, boolean.
+		/// </summary>
+		int mix[4] = { 4, 3, 2, 1 };
+		/// <summary>
+		/// Comment lines per 1000 entries.
+		/// </summary>
+		int commentsPerMille = 100;
+		/// <summary>
+		/// Ends lines with "\r\n" instead of "\n".
+		/// </summary>
+		bool crlf = false;
+		/// <summary>
+		/// Seed of the generator, equal options and seed give byte identical documents.
+		/// </summary>
+		uint64_t seed = 0x544F4D4Cull;
+	};
+
+	/// <summary>
+	/// Generated document along with the lookup paths it is known to contain.
+	/// </summary>
+	struct Corpus {
+		std::string text;
+		/// <summary>
+		/// "table/key" paths of every entry, in document order.
+		/// </summary>
+		std::vector<std::string> paths;
+		size_t lines = 0;
+		/// <summary>
+		/// Entries generated per kind: string, integer, decimal, boolean.
+		/// </summary>
+		size_t kinds[4] = { 0, 0, 0, 0 };
+
+		/// <summary>
+		/// Mutable null terminated copy of the text, the parser works in place. Free with free().
+		/// </summary>
+		char* Duplicate() const {
+			char* copy = (char*)malloc(text.size() + 1);
+			memcpy(copy, text.c_str(), text.size() + 1);
+			return copy;
+		}
+	};
+
+	/// <summary>
+	/// Deterministic xorshift64* sequence, independent of the platform rand().
+	/// </summary>
+	struct Random {
+		uint64_t state;
+		explicit Random(uint64_t seed) : state(seed ? seed : 1) {}
+		uint64_t Next() {
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			return state * 0x2545F4914F6CDD1Dull;
+		}
+		/// <summary>
+		/// Uniform value in [0, bound).
+		/// </summary>
+		uint32_t Below(uint32_t bound) {
+			return (uint32_t)((Next() >> 32) % bound);
+		}
+	};
+
+	/// <summary>
+	/// Synthetic document generator.
+	/// </summary>
+	class CorpusGenerator {
+	public:
+		static Corpus Generate(const CorpusOptions& options) {
+			Corpus corpus;
+			Random random(options.seed);
+			const char* newline = options.crlf ? "\r\n" : "\n";
+			int tables = options.tables > 0 ? options.tables : 1;
+			int weights = 0;
+			for (int i = 0; i < 4; i++) {
+				weights += options.mix[i] > 0 ? options.mix[i] : 0;
+			}
+			// Rough line estimate, only used to spread the entries between the tables.
+			size_t estimated = options.targetBytes / (size_t)(options.keyLength + 16) + 1;
+			size_t perTable = estimated / (size_t)tables + 1;
+			corpus.text.reserve(options.targetBytes + 256);
+
+			char table[32];
+			char key[96];
+			char value[64];
+			int current = -1;
+			size_t entry = 0;
+			while (corpus.text.size() < options.targetBytes) {
+				int target = (int)(entry / perTable);
+				if (target != current && target < tables) {
+					current = target;
+					snprintf(table, sizeof(table), "table_%d", current);
+					corpus.text += '[';
+					corpus.text += table;
+					corpus.text += ']';
+					corpus.text += newline;
+					corpus.lines++;
+				}
+				if (options.commentsPerMille > 0 && random.Below(1000) < (uint32_t)options.commentsPerMille) {
+					corpus.text += "# generated comment line ";
+					corpus.text += std::to_string(random.Below(100000));
+					corpus.text += newline;
+					corpus.lines++;
+				}
+				MakeKey(key, sizeof(key), options.keyLength, entry, random);
+				int kind = PickKind(options, weights, random);
+				MakeValue(value, sizeof(value), kind, random);
+				corpus.kinds[kind]++;
+
+				corpus.text += key;
+				corpus.text += " = ";
+				corpus.text += value;
+				corpus.text += newline;
+				corpus.lines++;
+				corpus.paths.push_back(std::string(table) + "/" + key);
+				entry++;
+			}
+			return corpus;
+		}
+	private:
+		static int PickKind(const CorpusOptions& options, int weights, Random& random) {
+			if (weights <= 0) {
+				return 0;
+			}
+			int pick = (int)random.Below((uint32_t)weights);
+			for (int i = 0; i < 4; i++) {
+				int weight = options.mix[i] > 0 ? options.mix[i] : 0;
+				if (pick < weight) {
+					return i;
+				}
+				pick -= weight;
+			}
+			return 0;
+		}
+		/// <summary>
+		/// Random lowercase prefix followed by the entry number, padded or cut to the requested length.
+		/// </summary>
+		static void MakeKey(char* buffer, size_t capacity, int length, size_t entry, Random& random) {
+			char suffix[24];
+			int suffixLength = snprintf(suffix, sizeof(suffix), "_%zu", entry);
+			if (length < suffixLength + 1) {
+				length = suffixLength + 1;
+			}
+			if ((size_t)length >= capacity) {
+				length = (int)capacity - 1;
+			}
+			int prefix = length - suffixLength;
+			for (int i = 0; i < prefix; i++) {
+				buffer[i] = (char)('a' + random.Below(26));
+			}
+			memcpy(buffer + prefix, suffix, (size_t)suffixLength);
+			buffer[length] = 0;
+		}
+		static void MakeValue(char* buffer, size_t capacity, int kind, Random& random) {
+			switch (kind) {
+			case 1:
+				snprintf(buffer, capacity, "%d", (int)random.Below(2000000) - 1000000);
+				break;
+			case 2:
+				snprintf(buffer, capacity, "%u.%03u", random.Below(100000), random.Below(1000));
+				break;
+			case 3:
+				snprintf(buffer, capacity, "%s", random.Below(2) ? "true" : "false");
+				break;
+			default: {
+				int length = 4 + (int)random.Below(24);
+				buffer[0] = '"';
+				for (int i = 1; i <= length; i++) {
+					buffer[i] = (char)('a' + random.Below(26));
+				}
+				buffer[length + 1] = '"';
+				buffer[length + 2] = 0;
+				break;
+			}
+			}
+		}
+	};
+}
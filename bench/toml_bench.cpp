@@ -0,0 +1,365 @@
+// Parser benchmark. Generates a deterministic corpus, measures parsing, lookups and the
+// entry getters, and prints a single JSON object so results can be diffed between releases.
+//
+// Usage: toml_bench [--size bytes] [--tables n] [--key-length n] [--mix s,i,d,b]
+//                   [--comments per-mille] [--crlf] [--seed n] [--iterations n]
+//                   [--lookups n] [--eager] [--lazy] [--grouped] [--threads n] [--out file]
+#include "System.h"
+#include "toml.hpp"
+#include "corpus.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace System::Serialization::TOMLANG;
+using namespace TOMLBench;
+
+namespace {
+	typedef std::chrono::steady_clock Clock;
+
+	/// <summary>
+	/// Lookups per timed batch, single lookups are below the clock resolution.
+	/// </summary>
+	const int LookupBatch = 16;
+
+	struct BenchOptions {
+		CorpusOptions corpus;
+		int iterations = 10;
+		int lookups = 100000;
+		bool eager = false;
+		bool lazy = false;
+		bool grouped = false;
+		int threads = 1;
+		const char* out = nullptr;
+	};
+
+	struct Percentiles {
+		double p50 = 0, p90 = 0, p99 = 0, max = 0;
+	};
+
+	double Nanoseconds(Clock::time_point begin, Clock::time_point end) {
+		return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+	}
+
+	Percentiles Summarize(std::vector<double>& samples) {
+		Percentiles result;
+		if (samples.empty()) {
+			return result;
+		}
+		std::sort(samples.begin(), samples.end());
+		size_t last = samples.size() - 1;
+		result.p50 = samples[last * 50 / 100];
+		result.p90 = samples[last * 90 / 100];
+		result.p99 = samples[last * 99 / 100];
+		result.max = samples[last];
+		return result;
+	}
+
+	/// <summary>
+	/// Peak resident set of the process in bytes, 0 where the platform does not report it.
+	/// </summary>
+	size_t PeakResident() {
+#if defined(__unix__) || defined(__APPLE__)
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+			return (size_t)usage.ru_maxrss;
+#else
+			return (size_t)usage.ru_maxrss * 1024;
+#endif
+		}
+#endif
+		return 0;
+	}
+
+	bool ParseArguments(int argc, char** argv, BenchOptions& options) {
+		for (int i = 1; i < argc; i++) {
+			const char* arg = argv[i];
+			const char* next = i + 1 < argc ? argv[i + 1] : nullptr;
+			if (!strcmp(arg, "--crlf")) {
+				options.corpus.crlf = true;
+			}
+			else if (!strcmp(arg, "--eager")) {
+				options.eager = true;
+			}
+			else if (!strcmp(arg, "--lazy")) {
+				options.lazy = true;
+			}
+			else if (!strcmp(arg, "--grouped")) {
+				options.grouped = true;
+			}
+			else if (!next) {
+				fprintf(stderr, "missing value for %s\n", arg);
+				return false;
+			}
+			else if (!strcmp(arg, "--size")) {
+				options.corpus.targetBytes = (size_t)strtoull(argv[++i], nullptr, 10);
+			}
+			else if (!strcmp(arg, "--tables")) {
+				options.corpus.tables = atoi(argv[++i]);
+			}
+			else if (!strcmp(arg, "--key-length")) {
+				options.corpus.keyLength = atoi(argv[++i]);
+			}
+			else if (!strcmp(arg, "--mix")) {
+				if (sscanf(argv[++i], "%d,%d,%d,%d", &options.corpus.mix[0], &options.corpus.mix[1], &options.corpus.mix[2], &options.corpus.mix[3]) != 4) {
+					fprintf(stderr, "--mix expects four weights: string,integer,decimal,boolean\n");
+					return false;
+				}
+			}
+			else if (!strcmp(arg, "--comments")) {
+				options.corpus.commentsPerMille = atoi(argv[++i]);
+			}
+			else if (!strcmp(arg, "--seed")) {
+				options.corpus.seed = (uint64_t)strtoull(argv[++i], nullptr, 0);
+			}
+			else if (!strcmp(arg, "--iterations")) {
+				options.iterations = std::max(1, atoi(argv[++i]));
+			}
+			else if (!strcmp(arg, "--lookups")) {
+				options.lookups = std::max(LookupBatch, atoi(argv[++i]));
+			}
+			else if (!strcmp(arg, "--threads")) {
+				options.threads = std::max(1, atoi(argv[++i]));
+			}
+			else if (!strcmp(arg, "--out")) {
+				options.out = argv[++i];
+			}
+			else {
+				fprintf(stderr, "unknown argument %s\n", arg);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Times batches of lookups, recording the mean latency of every batch.
+	/// </summary>
+	Percentiles MeasureLookups(TOML& toml, const std::vector<std::string>& paths, int lookups, int& found) {
+		std::vector<double> samples;
+		samples.reserve((size_t)(lookups / LookupBatch));
+		found = 0;
+		size_t cursor = 0;
+		for (int batch = 0; batch < lookups / LookupBatch; batch++) {
+			Clock::time_point begin = Clock::now();
+			for (int i = 0; i < LookupBatch; i++) {
+				found += toml.FindEntryIndex(paths[cursor].c_str()) != -1;
+				cursor = cursor + 1 < paths.size() ? cursor + 1 : 0;
+			}
+			samples.push_back(Nanoseconds(begin, Clock::now()) / LookupBatch);
+		}
+		return Summarize(samples);
+	}
+
+	/// <summary>
+	/// Same lookups as MeasureLookups, LookupBatch paths per call of the batch API.
+	/// </summary>
+	Percentiles MeasureBatchLookups(TOML& toml, const std::vector<std::string>& paths, int lookups, int& found) {
+		std::vector<const char*> pointers(paths.size());
+		for (size_t i = 0; i < paths.size(); i++) {
+			pointers[i] = paths[i].c_str();
+		}
+		std::vector<double> samples;
+		samples.reserve((size_t)(lookups / LookupBatch));
+		found = 0;
+		const char* batch[LookupBatch];
+		int indexes[LookupBatch];
+		size_t cursor = 0;
+		for (int round = 0; round < lookups / LookupBatch; round++) {
+			for (int i = 0; i < LookupBatch; i++) {
+				batch[i] = pointers[cursor];
+				cursor = cursor + 1 < pointers.size() ? cursor + 1 : 0;
+			}
+			Clock::time_point begin = Clock::now();
+			found += toml.FindEntryIndexes(batch, LookupBatch, indexes);
+			samples.push_back(Nanoseconds(begin, Clock::now()) / LookupBatch);
+		}
+		return Summarize(samples);
+	}
+
+	/// <summary>
+	/// Mean cost of visiting every table and reading the key and value of each of its entries,
+	/// in nanoseconds per entry.
+	/// </summary>
+	double MeasureTableScan(TOML& toml, size_t& visited) {
+		const Root& root = *toml.Contents.operator->();
+		const int rounds = 8;
+		size_t sink = 0;
+		Clock::time_point begin = Clock::now();
+		for (int round = 0; round < rounds; round++) {
+			for (int table = 0; table < root.pathCount(); table++) {
+				EntrySequence entries = root.getTableEntries(table);
+				for (EntrySequence::Iterator i = entries.begin(); i != entries.end(); ++i) {
+					sink += root.Columns.KeyLengths[*i] + root.Columns.ValueLengths[*i];
+				}
+			}
+		}
+		double elapsed = Nanoseconds(begin, Clock::now());
+		visited = (size_t)root.getLength() * rounds;
+		volatile size_t keep = sink;
+		(void)keep;
+		return visited ? elapsed / (double)visited : 0;
+	}
+
+	/// <summary>
+	/// Mean cost of the getter matching every entry of the given kind, in nanoseconds per call.
+	/// </summary>
+	double MeasureGetter(TOML& toml, Kind kind, size_t& calls) {
+		std::vector<Entry*> entries;
+		for (size_t i = 0; i < toml.Count(); i++) {
+			if (toml.Contents->getKind((int)i) == kind) {
+				entries.push_back(&toml[i]);
+			}
+		}
+		calls = 0;
+		if (entries.empty()) {
+			return 0;
+		}
+		char buffer[256];
+		volatile double sink = 0;
+		const int rounds = 8;
+		Clock::time_point begin = Clock::now();
+		for (int round = 0; round < rounds; round++) {
+			for (size_t i = 0; i < entries.size(); i++) {
+				Entry* entry = entries[i];
+				switch (kind) {
+				case Kind::Integer:
+					sink = sink + entry->getInt();
+					break;
+				case Kind::Double:
+					sink = sink + entry->getDecimal();
+					break;
+				case Kind::Bool:
+					sink = sink + entry->getBoolean();
+					break;
+				default:
+					sink = sink + entry->Output(buffer, sizeof(buffer));
+					break;
+				}
+			}
+		}
+		calls = entries.size() * rounds;
+		return Nanoseconds(begin, Clock::now()) / (double)calls;
+	}
+
+	void WritePercentiles(FILE* out, const char* name, const Percentiles& value, bool last) {
+		fprintf(out, "    \"%s\": { \"p50_ns\": %.1f, \"p90_ns\": %.1f, \"p99_ns\": %.1f, \"max_ns\": %.1f }%s\n",
+			name, value.p50, value.p90, value.p99, value.max, last ? "" : ",");
+	}
+}
+
+int main(int argc, char** argv) {
+	BenchOptions options;
+	if (!ParseArguments(argc, argv, options)) {
+		return 2;
+	}
+	Corpus corpus = CorpusGenerator::Generate(options.corpus);
+	char* text = corpus.Duplicate();
+	size_t length = corpus.text.size();
+	ParseOptions parseOptions;
+	parseOptions.eagerDecode = options.eager;
+	parseOptions.lazy = options.lazy;
+	parseOptions.groupTables = options.grouped;
+	parseOptions.threads = options.threads;
+
+	// Parse throughput, the best and median runs of fresh documents over the same buffer.
+	std::vector<double> runs;
+	for (int i = 0; i < options.iterations; i++) {
+		TOML toml(text);
+		TOMLResultStatus status(Sucess);
+		Clock::time_point begin = Clock::now();
+		Boolean parsed = Parser::Parse(text, length, &toml, parseOptions, &status);
+		runs.push_back(Nanoseconds(begin, Clock::now()));
+		toml.Destroy();
+		if (!parsed) {
+			fprintf(stderr, "parse failed with status %d\n", (int)status.StatusCode);
+			free(text);
+			return 1;
+		}
+	}
+	std::sort(runs.begin(), runs.end());
+	double best = runs.front();
+	double median = runs[runs.size() / 2];
+
+	// Lookups and getters run against one resident document, parsed with the statistics enabled
+	// for the phase breakdown.
+	TOML toml(text);
+	ParseStatistics statistics;
+	ParseOptions instrumented = parseOptions;
+	instrumented.statistics = &statistics;
+	Parser::Parse(text, length, &toml, instrumented, nullptr);
+	size_t arena = toml.Contents->Storage.getCapacity();
+
+	std::vector<std::string> misses;
+	misses.reserve(corpus.paths.size());
+	for (size_t i = 0; i < corpus.paths.size(); i++) {
+		misses.push_back(corpus.paths[i] + "_missing");
+	}
+	int hitsFound = 0;
+	int missesFound = 0;
+	Percentiles hit = MeasureLookups(toml, corpus.paths, options.lookups, hitsFound);
+	Percentiles miss = MeasureLookups(toml, misses, options.lookups, missesFound);
+	int batchHitsFound = 0, batchMissesFound = 0;
+	Percentiles batchHit = MeasureBatchLookups(toml, corpus.paths, options.lookups, batchHitsFound);
+	Percentiles batchMiss = MeasureBatchLookups(toml, misses, options.lookups, batchMissesFound);
+
+	static const Kind kinds[4] = { Kind::String, Kind::Integer, Kind::Double, Kind::Bool };
+	static const char* kindNames[4] = { "string", "integer", "decimal", "boolean" };
+	double getterCost[4];
+	size_t getterCalls[4];
+	for (int i = 0; i < 4; i++) {
+		getterCost[i] = MeasureGetter(toml, kinds[i], getterCalls[i]);
+	}
+	size_t scanned = 0;
+	double scanCost = MeasureTableScan(toml, scanned);
+	size_t entries = toml.Count();
+	toml.Destroy();
+	free(text);
+
+	FILE* out = options.out ? fopen(options.out, "w") : stdout;
+	if (!out) {
+		fprintf(stderr, "cannot open %s\n", options.out);
+		return 1;
+	}
+	const double megabyte = 1024.0 * 1024.0;
+	fprintf(out, "{\n");
+	fprintf(out, "  \"corpus\": { \"bytes\": %zu, \"lines\": %zu, \"entries\": %zu, \"tables\": %d, \"key_length\": %d, \"mix\": [%d, %d, %d, %d], \"comments_per_mille\": %d, \"crlf\": %s, \"seed\": %llu },\n",
+		length, corpus.lines, entries, options.corpus.tables, options.corpus.keyLength,
+		options.corpus.mix[0], options.corpus.mix[1], options.corpus.mix[2], options.corpus.mix[3],
+		options.corpus.commentsPerMille, options.corpus.crlf ? "true" : "false", (unsigned long long)options.corpus.seed);
+	fprintf(out, "  \"parse\": { \"iterations\": %d, \"eager\": %s, \"lazy\": %s, \"threads\": %d, \"best_ns\": %.0f, \"median_ns\": %.0f, \"mb_per_s\": %.2f, \"lines_per_s\": %.0f },\n",
+		options.iterations, options.eager ? "true" : "false", options.lazy ? "true" : "false", options.threads, best, median,
+		(double)length / megabyte / (median / 1e9), (double)corpus.lines / (median / 1e9));
+	fprintf(out, "  \"phases\": { \"tokenize_ns\": %llu, \"classify_ns\": %llu, \"build_ns\": %llu, \"fallthroughs\": %u, \"unclassified_lines\": %u },\n",
+		(unsigned long long)statistics.tokenizeNanoseconds, (unsigned long long)statistics.classifyNanoseconds,
+		(unsigned long long)statistics.buildNanoseconds, statistics.fallthroughs, statistics.results[NotValidTryNext]);
+	fprintf(out, "  \"lookup\": {\n");
+	fprintf(out, "    \"samples\": %d, \"hits_found\": %d, \"misses_found\": %d, \"batch_hits_found\": %d, \"batch_misses_found\": %d,\n",
+		options.lookups / LookupBatch * LookupBatch, hitsFound, missesFound, batchHitsFound, batchMissesFound);
+	WritePercentiles(out, "hit", hit, false);
+	WritePercentiles(out, "miss", miss, false);
+	WritePercentiles(out, "batch_hit", batchHit, false);
+	WritePercentiles(out, "batch_miss", batchMiss, true);
+	fprintf(out, "  },\n");
+	fprintf(out, "  \"table_scan\": { \"grouped\": %s, \"entries\": %zu, \"ns_per_entry\": %.2f },\n", options.grouped ? "true" : "false", scanned, scanCost);
+	fprintf(out, "  \"getters\": {\n");
+	for (int i = 0; i < 4; i++) {
+		fprintf(out, "    \"%s\": { \"calls\": %zu, \"ns_per_call\": %.2f }%s\n", kindNames[i], getterCalls[i], getterCost[i], i == 3 ? "" : ",");
+	}
+	fprintf(out, "  },\n");
+	fprintf(out, "  \"memory\": { \"document_arena_bytes\": %zu, \"document_bytes\": %zu, \"peak_resident_bytes\": %zu }\n", arena, statistics.memory, PeakResident());
+	fprintf(out, "}\n");
+	if (out != stdout) {
+		fclose(out);
+	}
+	return 0;
+}
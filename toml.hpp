@@ -11,6 +11,44 @@
 
 #include "System.h"
 #include "text_reader.hpp"
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TOML_MAPPED_FILES 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <locale.h>
+#if defined(__GLIBC__) || defined(__APPLE__)
+#define TOML_C_LOCALE 1
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+#endif
+
+#if defined(__CELLOS_LV2__)
+#define TOML_THREADS 1
+#include <sys/ppu_thread.h>
+#include <sys/sys_time.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define TOML_THREADS 1
+#include <pthread.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TOML_STRUCTURAL_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TOML_STRUCTURAL_AVX2 1
+#include <immintrin.h>
+#endif
 
 namespace System {
 	namespace Serialization {
@@ -29,6 +67,11 @@ namespace System {
 				Array,
 				Double,
 				Unknown,
+				/// <summary>
+				/// Entry of a lazily parsed document whose value was not classified yet, see ParseOptions::lazy.
+				/// Root::getKind never returns it.
+				/// </summary>
+				Unresolved = 0xFF,
 			};
 			static const char* TOMLKindToString(Kind x) {
 				switch (x)
@@ -39,7 +82,9 @@ namespace System {
 					RETNAMEOFINCASE(Integer);
 					RETNAMEOFINCASE(String);
 					RETNAMEOFINCASE(Array);
+					RETNAMEOFINCASE(Double);
 					RETNAMEOFINCASE(Unknown);
+					RETNAMEOFINCASE(Unresolved);
 
 				}
 				return "";
@@ -93,18 +138,328 @@ namespace System {
 				HResult Valuable;
 				TOMLResultStatus(TOMLResultStatusCode x) : StatusCode(x), Valuable(0) {}
 				TOMLResultStatus(TOMLResultStatusCode x, HResult xc) : StatusCode(x), Valuable(xc) {}
-				TOMLResultStatus& operator =(TOMLResultStatus& x) {
-					StatusCode = x.StatusCode;
-					Valuable = x.Valuable;
-					return *this;
-				}
 			};
 			struct TOMLToken {
 				char* contents;
 				int length;
 			};
+			/// <summary>
+			/// FNV-1a hashing shared by the document lookup indexes.
+			/// </summary>
+			struct TOMLHash {
+				static const uint32_t Seed = 2166136261u;
+				static const uint32_t Prime = 16777619u;
+				/// <summary>
+				/// Separator mixed between a table name and a key, mirrors the '/' of a full path.
+				/// </summary>
+				static const char Separator = '/';
+				static uint32_t Append(uint32_t hash, const char* data, int length) {
+					for (int i = 0; i < length; i++) {
+						hash ^= (unsigned char)data[i];
+						hash *= Prime;
+					}
+					return hash;
+				}
+				static uint32_t Of(const char* data, int length) {
+					return Append(Seed, data, length);
+				}
+				/// <summary>
+				/// 64-bit hash of a whole text, eight bytes per step, to tell whether a source changed.
+				/// Not suited for the lookup indexes, and not cryptographic.
+				/// </summary>
+				static uint64_t Content(const char* data, size_t length) {
+					const uint64_t prime = 0x100000001B3ull;
+					uint64_t hash = 0xCBF29CE484222325ull ^ (uint64_t)length;
+					size_t i = 0;
+					for (; i + 8 <= length; i += 8) {
+						uint64_t word;
+						Marshal::Copy(data + i, &word, 8);
+						hash = (hash ^ word) * prime;
+						hash ^= hash >> 29;
+					}
+					for (; i < length; i++) {
+						hash = (hash ^ (unsigned char)data[i]) * prime;
+					}
+					return hash;
+				}
+				/// <summary>
+				/// Hash of a (table, key) pair. The root table is the empty name.
+				/// </summary>
+				static uint32_t Of(const char* table, int tableLength, const char* key, int keyLength) {
+					uint32_t hash = Append(Seed, table, tableLength);
+					hash ^= (unsigned char)Separator;
+					hash *= Prime;
+					return Append(hash, key, keyLength);
+				}
+				/// <summary>
+				/// Compile time Append over a null terminated string.
+				/// </summary>
+				static constexpr uint32_t Fold(uint32_t hash, const char* data) {
+					return *data ? Fold((hash ^ (unsigned char)*data) * Prime, data + 1) : hash;
+				}
+				/// <summary>
+				/// Compile time Of(table, tableLength, key, keyLength), for literal names.
+				/// </summary>
+				static constexpr uint32_t OfPath(const char* table, const char* key) {
+					return Fold((Fold(Seed, table) ^ (unsigned char)Separator) * Prime, key);
+				}
+				/// <summary>
+				/// Compile time string length.
+				/// </summary>
+				static constexpr int Measure(const char* data) {
+					return *data ? 1 + Measure(data + 1) : 0;
+				}
+			};
 
 
+			/// <summary>
+			/// Bit helpers for the structural masks.
+			/// </summary>
+			struct Bits {
+				static int TrailingZeros(uint64_t x) {
+#if defined(__GNUC__)
+					return __builtin_ctzll(x);
+#else
+					int n = 0;
+					while (!(x & 1)) {
+						x >>= 1;
+						n++;
+					}
+					return n;
+#endif
+				}
+				static int PopCount(uint64_t x) {
+#if defined(__GNUC__)
+					return __builtin_popcountll(x);
+#else
+					int n = 0;
+					while (x) {
+						x &= x - 1;
+						n++;
+					}
+					return n;
+#endif
+				}
+				/// <summary>
+				/// Mask of the bits in the range [from, to).
+				/// </summary>
+				static uint64_t Range(int from, int to) {
+					uint64_t upper = to >= 64 ? ~0ull : ((1ull << to) - 1);
+					uint64_t lower = from >= 64 ? ~0ull : ((1ull << from) - 1);
+					return upper & ~lower;
+				}
+			};
+			/// <summary>
+			/// Classes of structural characters, also the slot of each mask in StructuralBlock.
+			/// </summary>
+			enum StructuralClass {
+				StructuralNewline,
+				StructuralEquals,
+				StructuralComment,
+				StructuralOpen,
+				StructuralClose,
+				StructuralQuote,
+				StructuralClassCount,
+			};
+			/// <summary>
+			/// Positions of the structural characters of a 64 byte block, bit i stands for the byte i.
+			/// </summary>
+			struct StructuralBlock {
+				uint64_t masks[StructuralClassCount];
+			};
+			/// <summary>
+			/// Structural index over a text, in the style of simdjson. Blocks of 64 bytes are classified
+			/// at once into bitmasks of '\n', '=', '#', '[', ']' and '"', so the parser jumps between
+			/// structural characters instead of walking every byte. Blocks are scanned on demand and the
+			/// last one is cached, which suits the forward only access of the parser.
+			/// </summary>
+			class StructuralScanner {
+			public:
+				static const int BlockSize = 64;
+				typedef void (*BlockFunction)(const char* block, StructuralBlock& output);
+			private:
+				const char* data;
+				size_t length;
+				size_t cachedBlock;
+				StructuralBlock cached;
+				BlockFunction scan;
+
+				static const char* Characters() {
+					return "\n=#[]\"";
+				}
+				/// <summary>
+				/// Byte to structural class lookup used by the scalar classification.
+				/// </summary>
+				struct ClassTable {
+					unsigned char classes[256];
+					ClassTable() {
+						sys::memset(classes, StructuralClassCount, sizeof(classes));
+						const char* characters = Characters();
+						for (int i = 0; i < StructuralClassCount; i++) {
+							classes[(unsigned char)characters[i]] = (unsigned char)i;
+						}
+					}
+				};
+				const StructuralBlock& Load(size_t block) {
+					if (block != cachedBlock) {
+						size_t offset = block * BlockSize;
+						if (offset + BlockSize <= length) {
+							scan(data + offset, cached);
+						}
+						else {
+							char padded[BlockSize];
+							sys::memset(padded, 0, BlockSize);
+							Marshal::Copy(data + offset, padded, length - offset);
+							scan(padded, cached);
+						}
+						cachedBlock = block;
+					}
+					return cached;
+				}
+			public:
+				StructuralScanner(const char* data, size_t length) : data(data), length(length), cachedBlock((size_t)-1), scan(Select()) {}
+				/// <summary>
+				/// Portable block classification, one table lookup per byte.
+				/// </summary>
+				static void ScanScalar(const char* block, StructuralBlock& output) {
+					static const ClassTable table;
+					uint64_t masks[StructuralClassCount + 1] = { 0 };
+					for (int i = 0; i < BlockSize; i++) {
+						masks[table.classes[(unsigned char)block[i]]] |= 1ull << i;
+					}
+					for (int i = 0; i < StructuralClassCount; i++) {
+						output.masks[i] = masks[i];
+					}
+				}
+#if TOML_STRUCTURAL_SSE2
+				static void ScanSSE2(const char* block, StructuralBlock& output) {
+					__m128i lanes[4];
+					for (int i = 0; i < 4; i++) {
+						lanes[i] = _mm_loadu_si128((const __m128i*)(block + i * 16));
+					}
+					const char* characters = Characters();
+					for (int c = 0; c < StructuralClassCount; c++) {
+						__m128i needle = _mm_set1_epi8(characters[c]);
+						uint64_t mask = 0;
+						for (int i = 0; i < 4; i++) {
+							mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(lanes[i], needle)) << (i * 16);
+						}
+						output.masks[c] = mask;
+					}
+				}
+#endif
+#if TOML_STRUCTURAL_AVX2
+				__attribute__((target("avx2")))
+				static void ScanAVX2(const char* block, StructuralBlock& output) {
+					__m256i low = _mm256_loadu_si256((const __m256i*)block);
+					__m256i high = _mm256_loadu_si256((const __m256i*)(block + 32));
+					const char* characters = Characters();
+					for (int c = 0; c < StructuralClassCount; c++) {
+						__m256i needle = _mm256_set1_epi8(characters[c]);
+						uint64_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, needle));
+						mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, needle)) << 32;
+						output.masks[c] = mask;
+					}
+				}
+#endif
+				/// <summary>
+				/// Picks the widest block classification supported by the running CPU, once.
+				/// </summary>
+				static BlockFunction Select() {
+					static const BlockFunction selected = Detect();
+					return selected;
+				}
+				static BlockFunction Detect() {
+					BlockFunction candidate = &ScanScalar;
+#if TOML_STRUCTURAL_SSE2
+					candidate = &ScanSSE2;
+#endif
+#if TOML_STRUCTURAL_AVX2
+					if (__builtin_cpu_supports("avx2")) {
+						candidate = &ScanAVX2;
+					}
+#endif
+					return candidate;
+				}
+				/// <summary>
+				/// Finds the next structural character of a class.
+				/// </summary>
+				/// <param name="kind">Structural class</param>
+				/// <param name="from">First offset to consider</param>
+				/// <param name="limit">Offset where the search stops</param>
+				/// <returns>Offset of the character or the limit if there is none</returns>
+				size_t Next(StructuralClass kind, size_t from, size_t limit) {
+					if (limit > length) {
+						limit = length;
+					}
+					while (from < limit) {
+						size_t block = from / BlockSize;
+						int bit = (int)(from % BlockSize);
+						uint64_t mask = Load(block).masks[kind] & ~Bits::Range(0, bit);
+						if (mask) {
+							size_t found = block * BlockSize + Bits::TrailingZeros(mask);
+							return found < limit ? found : limit;
+						}
+						from = (block + 1) * BlockSize;
+					}
+					return limit;
+				}
+				/// <summary>
+				/// Counts the structural characters of a class in the range [from, to).
+				/// </summary>
+				int Count(StructuralClass kind, size_t from, size_t to) {
+					int count = 0;
+					if (to > length) {
+						to = length;
+					}
+					while (from < to) {
+						size_t block = from / BlockSize;
+						size_t blockEnd = (block + 1) * BlockSize;
+						int last = (int)((to < blockEnd ? to : blockEnd) - block * BlockSize);
+						count += Bits::PopCount(Load(block).masks[kind] & Bits::Range((int)(from % BlockSize), last));
+						from = blockEnd;
+					}
+					return count;
+				}
+				/// <summary>
+				/// Length of the scanned content.
+				/// </summary>
+				size_t getLength() const {
+					return length;
+				}
+				/// <summary>
+				/// Finds the next comment character that is not enclosed by a string, counted from a start offset.
+				/// Basic strings may escape their quote with a backslash, literal strings in single quotes may not.
+				/// </summary>
+				size_t NextComment(size_t start, size_t limit) {
+					if (limit > length) {
+						limit = length;
+					}
+					size_t comment = Next(StructuralComment, start, limit);
+					if (comment == limit) {
+						return limit;
+					}
+					// A '#' is there, the strings before it are walked as ArrayView::SkipString does.
+					size_t i = start;
+					while (i < limit) {
+						char c = data[i];
+						if (c == '#') {
+							return i;
+						}
+						if (c == '"' || c == '\'') {
+							i++;
+							while (i < limit && data[i] != c) {
+								if (c == '"' && data[i] == '\\') {
+									i++;
+								}
+								i++;
+							}
+						}
+						i++;
+					}
+					return limit;
+				}
+			};
 			/// <summary>
 			/// Represents a path pointer who haves a known length in a text pool.
 			/// </summary>
@@ -113,20 +468,36 @@ namespace System {
 				/// [Not trivial] 
 				/// </summary>
 				char* pathName;
+				/// <summary>
+				/// [Not trivial] Length of the name up to the closing bracket.
+				/// </summary>
+				int length;
 			public:
 				/// <summary>
 				/// Creates a root path instance
 				/// </summary>
 				PathName() {
 					pathName = nullptr;
+					length = 0;
 				}
 				PathName(char* name, int length) {
 					pathName = name;
+					this->length = length;
+				}
+				/// <summary>
+				/// Measures a path token up to its closing bracket or the end of the line.
+				/// </summary>
+				static int MeasureName(const char* name) {
+					int length = 0;
+					while (name[length] && name[length] != ']' && name[length] != '\n' && name[length] != '\r') {
+						length++;
+					}
+					return length;
 				}
 				/// <summary>
 				/// Ensures the path is root (null).
 				/// </summary>
-				bool IsRoot() {
+				bool IsRoot() const {
 					return pathName == nullptr;
 				}
 				/// <summary>
@@ -143,6 +514,7 @@ namespace System {
 				/// </summary>
 				void Build() {
 					pathName = nullptr;
+					length = 0;
 				}
 				/// <summary>
 				/// [Factory] Build this instance as an specified path descriptor. 
@@ -151,6 +523,7 @@ namespace System {
 				/// <param name="length">Path token length</param>
 				void Build(char* name) {
 					pathName = name;
+					length = MeasureName(name);
 				}
 				/// <summary>
 				/// Outputs the path name.
@@ -171,8 +544,23 @@ namespace System {
 					}
 					return false;
 				}
+				/// <summary>
+				/// Exact comparison against a null terminated name.
+				/// </summary>
 				bool Equals(const char* name) const{
-					return safest_compare(this->pathName, name);
+					return name && Equals(name, (int)sys::strlen(name));
+				}
+				/// <summary>
+				/// Exact comparison against a name of known length. The root path matches the empty name.
+				/// </summary>
+				bool Equals(const char* name, int length) const {
+					return this->length == length && (length == 0 || strncmp(this->pathName, name, length) == 0);
+				}
+				/// <summary>
+				/// Length of the path name, zero for the root path.
+				/// </summary>
+				int GetLength() const {
+					return length;
 				}
 				/// <summary>
 				/// The position of this path determined by this instance from the root contents.
@@ -218,866 +606,5580 @@ namespace System {
 					this->token.contents = start;
 					this->token.length = length;
 				}
+			};
+			/// <summary>
+			/// Compact payload of a scalar decoded at parse time, tagged by the kind of its value.
+			/// </summary>
+			struct TOMLScalar {
+				union {
+					int64_t integer;
+					double decimal;
+				};
 				/// <summary>
-				/// Clears all the non trivial values of this instance.
+				/// Set once the payload holds the decoded value.
 				/// </summary>
-				~Value() {
-					Marshal::Clear(this, sizeof(*this));
+				bool decoded;
+				static TOMLScalar None() {
+					TOMLScalar scalar;
+					scalar.integer = 0;
+					scalar.decoded = false;
+					return scalar;
 				}
 			};
 			/// <summary>
-			/// Default entry key-value pair holder model. 
+			/// Digit runs decoded eight digits per step in a 64-bit word (SWAR).
 			/// </summary>
-			class Entry {
-			public:
-				/// <summary>
-				/// [Not trivial] Storage of this element's path on the root document.
-				/// </summary>
-				PathName* path;
+			struct DigitRun {
 				/// <summary>
-				/// [Not Trivial] Entry value descriptor
+				/// Loads eight characters with the first one in the lowest byte, whatever the byte order.
 				/// </summary>
-				Value value;
+				static uint64_t Load(const char* data) {
+					uint64_t word;
+					Marshal::Copy(data, &word, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+					word = __builtin_bswap64(word);
+#endif
+					return word;
+				}
+				static bool AllDigits(uint64_t word) {
+					return ((word & 0xF0F0F0F0F0F0F0F0ull) | (((word + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+				}
 				/// <summary>
-				/// [Factory] Build specifically this instance
+				/// Value of eight digit characters loaded by Load.
 				/// </summary>
-				/// <param name="path"></param>
-				/// <param name="kind"></param>
-				/// <param name="token"></param>
-				Entry(PathName* path, Kind kind, TOMLToken token) {
-					this->path = path;
-					value.kind = kind;
-					value.token = token;
+				static uint32_t ParseEight(uint64_t word) {
+					const uint64_t mask = 0x000000FF000000FFull;
+					const uint64_t high = 100ull + (1000000ull << 32);
+					const uint64_t low = 1ull + (10000ull << 32);
+					word -= 0x3030303030303030ull;
+					word = word * 10 + (word >> 8);
+					return (uint32_t)((((word & mask) * high) + (((word >> 16) & mask) * low)) >> 32);
 				}
 				/// <summary>
-				/// [Factory] Build this instance as an incompleted or in-processing entry.
+				/// Appends the digit run at data to value. Runs longer than 19 digits wrap, callers check the count.
 				/// </summary>
-				Entry() {
-					value.Build();
+				/// <returns>Count of digits read</returns>
+				static int Accumulate(const char* data, int length, uint64_t& value) {
+					int i = 0;
+					while (i + 8 <= length) {
+						uint64_t word = Load(data + i);
+						if (!AllDigits(word)) {
+							break;
+						}
+						value = value * 100000000ull + ParseEight(word);
+						i += 8;
+					}
+					while (i < length && data[i] >= '0' && data[i] <= '9') {
+						value = value * 10 + (uint64_t)(data[i] - '0');
+						i++;
+					}
+					return i;
 				}
 				/// <summary>
-				/// Outputs the valuable text of this string.
+				/// Plain decimal integer without leading zeros, false when the text needs ScalarDecoder::Integer.
 				/// </summary>
-				/// <param name="buffer"></param>
-				bool Output(char* buffer) {
-					int index = Text::IndexOf(value.token.contents, '=');
-					if (index != -1) {
-						char * data = value.token.contents + index + 1;
-						while (*data == ' ') {
-							data++;
-						}
-						int ln = Text::LineLength(data);
-						Marshal::Clear(buffer, ln);
-						Marshal::Copy(data, buffer, ln);
-						return true;
+				static bool Integer(const char* data, int length, int64_t& output) {
+					int i = 0;
+					bool negative = false;
+					if (length > 0 && (data[0] == '+' || data[0] == '-')) {
+						negative = data[0] == '-';
+						i = 1;
 					}
-					return false;
+					uint64_t value = 0;
+					int digits = Accumulate(data + i, length - i, value);
+					if (digits == 0 || digits > 19 || i + digits != length || (digits > 1 && data[i] == '0') ||
+						value > (negative ? 9223372036854775808ull : 9223372036854775807ull)) {
+						return false;
+					}
+					output = negative ? (int64_t)(0 - value) : (int64_t)value;
+					return true;
 				}
 				/// <summary>
-				/// Checks if this instance belongs to the document's root path.
+				/// Decimal number whose digits fit a double mantissa and whose exponent is within 10^22 once
+				/// folded into the mantissa, which one exact multiplication or division rounds correctly. False when the text needs ScalarDecoder::Decimal.
 				/// </summary>
-				/// <returns>Boolean</returns>
-				bool isRootPath() {
-					if (path) {
-						return path->IsRoot();
+				static bool Decimal(const char* data, int length, double& output) {
+					static const double powers[] = {
+						1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+						1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+					};
+					int i = 0;
+					bool negative = false;
+					if (length > 0 && (data[0] == '+' || data[0] == '-')) {
+						negative = data[0] == '-';
+						i = 1;
 					}
-					return path == nullptr;
-				}
-				int32_t getInt() {
-					char buffer[32];
-					if (!Output(buffer)) {
-						return 0;
+					uint64_t mantissa = 0;
+					int integerDigits = Accumulate(data + i, length - i, mantissa);
+					if (integerDigits > 1 && data[i] == '0') {
+						return false;
 					}
-					signed int value = Int::Parse(buffer);
-					Marshal::Clear(buffer);
-					return value;
-				}
-				double getDecimal() {
-					char buffer[32];
-					if (!Output(buffer)) {
-						return 0.0;
+					i += integerDigits;
+					int fractionDigits = 0;
+					if (i < length && data[i] == '.') {
+						i++;
+						fractionDigits = Accumulate(data + i, length - i, mantissa);
+						i += fractionDigits;
+						if (fractionDigits == 0) {
+							return false;
+						}
 					}
-					double value = Double::Parse(buffer);
-					Marshal::Clear(buffer);
-					return value;
-				}
-				float getFloat() {
-					char buffer[32];
-					if (!Output(buffer)) {
-						return 0.0f;
+					if (integerDigits == 0 || integerDigits + fractionDigits > 19) {
+						return false;
 					}
-					float value = Float::Parse(buffer);
-					Marshal::Clear(buffer);
-					return value;
-				}
-				signed char getBoolean() {
-					char buffer[32];
-
-					if (!Output(buffer)) {
-						return 0.0f;
+					int exponent = 0;
+					if (i < length && (data[i] == 'e' || data[i] == 'E')) {
+						i++;
+						bool negativeExponent = false;
+						if (i < length && (data[i] == '+' || data[i] == '-')) {
+							negativeExponent = data[i] == '-';
+							i++;
+						}
+						int exponentDigits = 0;
+						while (i < length && data[i] >= '0' && data[i] <= '9' && exponentDigits < 4) {
+							exponent = exponent * 10 + (data[i] - '0');
+							exponentDigits++;
+							i++;
+						}
+						if (exponentDigits == 0) {
+							return false;
+						}
+						exponent = negativeExponent ? -exponent : exponent;
 					}
-					signed char value = Boolean::Parse(buffer);
-					Marshal::Clear(buffer);
-					return value;
-				}
-				/// <summary>
-				/// Clears all the non-trivial values determined by this class.
-				/// </summary>
-				~Entry() {
-					Marshal::Clear(this, sizeof(*this));
-				}
-			};
-			/// <summary>
-			/// Comment entry holder class. Alias for an token.
-			/// </summary>
-			class CommentEntry {
-			public:
-				int index;
-				int length;
-				CommentEntry() {}
-				CommentEntry(int c, int l) : index(c), length(l) {}
-				~CommentEntry() {
-					Marshal::Clear(this, sizeof(*this));
+					exponent -= fractionDigits;
+					if (i != length || mantissa > (1ull << 53) || exponent < -22) {
+						return false;
+					}
+					// Large exponents still qualify while the extra powers of ten keep the mantissa exact.
+					while (exponent > 22 && mantissa <= (1ull << 53) / 10) {
+						mantissa *= 10;
+						exponent--;
+					}
+					if (exponent > 22) {
+						return false;
+					}
+					double value = (double)mantissa;
+					value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+					output = negative ? -value : value;
+					return true;
 				}
 			};
 			/// <summary>
-			/// Represents the main root contents and container of a TOML document.
+			/// Decoding of scalar value tokens in place, the tokens need no terminator.
 			/// </summary>
-			class Root {
-				int idxPaths = 0;
-				int idxEntries = 0;
-				int idxComments = 0;
-			public:
+			struct ScalarDecoder {
 				/// <summary>
-				/// Factory Initialize
+				/// Decodes an integer in any TOML form: decimal with an optional sign, or 0x, 0o and 0b
+				/// prefixed without one. Single underscores may separate digits, decimals may not start with a zero.
 				/// </summary>
-				Root(no_init) {
-				}
-				Root() {
-					idxPaths = 0;
-					idxEntries = 0;
-					idxComments = 0;
+				/// <returns>Sucess, Overflow past the int64 range or UnexpectedToken</returns>
+				static TOMLResultStatus Integer(const char* value, int length, int64_t& output) {
+					int i = 0;
+					bool negative = false;
+					if (length > 0 && (value[0] == '+' || value[0] == '-')) {
+						negative = value[0] == '-';
+						i = 1;
+					}
+					if (i == length) {
+						return UnexpectedToken;
+					}
+					if (length - i > 2 && value[i] == '0' && (value[i + 1] == 'x' || value[i + 1] == 'o' || value[i + 1] == 'b')) {
+						if (i) {
+							return UnexpectedToken;
+						}
+						return Prefixed(value + 2, length - 2, value[1] == 'x' ? 4 : value[1] == 'o' ? 3 : 1, output);
+					}
+					if (length - i > 1 && value[i] == '0') {
+						return UnexpectedToken;
+					}
+					uint64_t magnitude = 0;
+					int digits = 0;
+					for (;;) {
+						int run = DigitRun::Accumulate(value + i, length - i, magnitude);
+						if (run == 0) {
+							return UnexpectedToken;
+						}
+						digits += run;
+						i += run;
+						if (i == length) {
+							break;
+						}
+						if (value[i] != '_') {
+							return UnexpectedToken;
+						}
+						i++;
+					}
+					if (digits > 19) {
+						// The accumulation may have wrapped, count again with a check per digit.
+						magnitude = 0;
+						for (i = (value[0] == '+' || value[0] == '-') ? 1 : 0; i < length; i++) {
+							if (value[i] == '_') {
+								continue;
+							}
+							uint64_t digit = (uint64_t)(value[i] - '0');
+							if (magnitude > (18446744073709551615ull - digit) / 10) {
+								return Overflow;
+							}
+							magnitude = magnitude * 10 + digit;
+						}
+					}
+					if (magnitude > (negative ? 9223372036854775808ull : 9223372036854775807ull)) {
+						return Overflow;
+					}
+					output = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+					return Sucess;
 				}
-				
-				PathName* Paths;
-				Entry* Entries;
-				CommentEntry* Commentaries;
 				/// <summary>
-				/// The document original data.
+				/// Decodes a decimal number with an optional sign, fraction and exponent, single underscores
+				/// between digits, or a signed inf and nan. Values are correctly rounded: exactly representable
+				/// ones are built from the digits, the others go through strtod in the "C" locale.
+				/// The integer part may not start with a zero, unless it is that zero alone.
 				/// </summary>
-				char* Data;
+				/// <returns>Sucess, UnexpectedToken, InvalidFloatFormat or FloatingPointUnexpectedDecimalGap</returns>
+				static TOMLResultStatus Decimal(const char* value, int length, double& output) {
+					if (DigitRun::Decimal(value, length, output)) {
+						return Sucess;
+					}
+					char buffer[DecimalCapacity];
+					int i = 0;
+					int cleaned = 0;
+					if (length > 0 && (value[0] == '+' || value[0] == '-')) {
+						buffer[cleaned++] = value[i++];
+					}
+					if (length - i == 3 && (strncmp(value + i, "inf", 3) == 0 || strncmp(value + i, "nan", 3) == 0)) {
+						double special = value[i] == 'i' ? HUGE_VAL : NAN;
+						output = i && value[0] == '-' ? -special : special;
+						return Sucess;
+					}
+					if (length - i > 1 && value[i] == '0' && ((value[i + 1] >= '0' && value[i + 1] <= '9') || value[i + 1] == '_')) {
+						return UnexpectedToken;
+					}
+					if (CopyDigits(value, length, i, buffer, cleaned) <= 0) {
+						return InvalidFloatFormat;
+					}
+					if (i < length && value[i] == '.') {
+						buffer[cleaned++] = value[i++];
+						if (CopyDigits(value, length, i, buffer, cleaned) <= 0) {
+							return InvalidFloatFormat;
+						}
+					}
+					if (i < length && (value[i] == 'e' || value[i] == 'E')) {
+						buffer[cleaned++] = value[i++];
+						if (i < length && (value[i] == '+' || value[i] == '-')) {
+							buffer[cleaned++] = value[i++];
+						}
+						if (CopyDigits(value, length, i, buffer, cleaned) <= 0) {
+							return InvalidFloatFormat;
+						}
+					}
+					if (i != length) {
+						return value[i] == '.' ? FloatingPointUnexpectedDecimalGap : InvalidFloatFormat;
+					}
+					buffer[cleaned] = 0;
+					if (!DigitRun::Decimal(buffer, cleaned, output)) {
+						output = ConvertDecimal(buffer);
+					}
+					return Sucess;
+				}
 				/// <summary>
-				/// Get the count of the collected entries.
+				/// strtod in the "C" locale, TOML decimals use '.' whatever the locale of the program.
+				/// Without strtod_l the point is swapped for the separator of the current locale.
 				/// </summary>
-				/// <returns>integer</returns>
-				int getLength() const{
-					return idxEntries;
+				/// <param name="text">Cleaned decimal, null terminated, modified without strtod_l</param>
+				static double ConvertDecimal(char* text) {
+#if TOML_C_LOCALE
+					static const locale_t classic = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+					if (classic) {
+						return strtod_l(text, nullptr, classic);
+					}
+#endif
+					char point = localeconv()->decimal_point[0];
+					char* dot = point != '.' ? strchr(text, '.') : nullptr;
+					if (dot) {
+						*dot = point;
+					}
+					return strtod(text, nullptr);
 				}
 				/// <summary>
-				/// Get the count of the collected paths.
+				/// Longest decimal handled, once underscores are removed.
 				/// </summary>
-				/// <returns>integer</returns>
-				int pathCount()const {
-					return idxPaths;
+				static const int DecimalCapacity = 128;
+			private:
+				/// <summary>
+				/// Decodes the digits of a 0x, 0o or 0b integer.
+				/// </summary>
+				/// <param name="bits">Bits per digit</param>
+				static TOMLResultStatus Prefixed(const char* digits, int length, int bits, int64_t& output) {
+					uint64_t magnitude = 0;
+					bool lastDigit = false;
+					for (int i = 0; i < length; i++) {
+						char c = digits[i];
+						if (c == '_') {
+							if (!lastDigit) {
+								return UnexpectedToken;
+							}
+							lastDigit = false;
+							continue;
+						}
+						int digit = c >= '0' && c <= '9' ? c - '0' : (c | 0x20) >= 'a' && (c | 0x20) <= 'f' ? (c | 0x20) - 'a' + 10 : 16;
+						if (digit >= (1 << bits)) {
+							return UnexpectedToken;
+						}
+						if (magnitude >> (63 - bits)) {
+							return Overflow;
+						}
+						magnitude = (magnitude << bits) | (uint64_t)digit;
+						lastDigit = true;
+					}
+					if (!lastDigit) {
+						return UnexpectedToken;
+					}
+					output = (int64_t)magnitude;
+					return Sucess;
 				}
 				/// <summary>
-				/// Get the count of the collected comments.
+				/// Copies a digit run, dropping the underscores between digits.
 				/// </summary>
-				/// <returns>integer</returns>
-				int commentCount() const {
-					return idxComments;
+				/// <returns>Count of digits, -1 for a misplaced underscore or a run too long for the buffer</returns>
+				static int CopyDigits(const char* value, int length, int& i, char* buffer, int& cleaned) {
+					int count = 0;
+					while (i < length) {
+						char c = value[i];
+						if (c >= '0' && c <= '9') {
+							if (cleaned >= DecimalCapacity - 8) {
+								return -1;
+							}
+							buffer[cleaned++] = c;
+							count++;
+						}
+						else if (c == '_') {
+							if (count == 0 || i + 1 >= length || value[i + 1] < '0' || value[i + 1] > '9') {
+								return -1;
+							}
+						}
+						else {
+							break;
+						}
+						i++;
+					}
+					return count;
 				}
+			public:
 				/// <summary>
-				/// Push an entry.
+				/// Decodes a boolean literal.
 				/// </summary>
-				/// <param name="entryModelInstance"></param>
-				void AddEntry(Entry entryModelInstance) {
-					//Contents.Push(entryModelInstance);
-					Entries[idxEntries].path = entryModelInstance.path;
-					Entries[idxEntries].value = entryModelInstance.value;
-					idxEntries++;
+				/// <returns>Sucess or UnexpectedToken</returns>
+				static TOMLResultStatus Bool(const char* value, int length, bool& output) {
+					if (length == 4 && strncmp(value, BOOLEAN_TRUE_LITERAL, 4) == 0) {
+						output = true;
+						return Sucess;
+					}
+					if (length == 5 && strncmp(value, BOOLEAN_FALSE_LITERAL, 5) == 0) {
+						output = false;
+						return Sucess;
+					}
+					return UnexpectedToken;
 				}
 				/// <summary>
-				/// [Generation only] Register an specified entry
+				/// Decodes the trimmed value token of an integer, decimal or boolean entry.
 				/// </summary>
-				/// <param name="entryModelInstance"></param>
-				void AddEntry(PathName* path, Kind kind, TOMLToken token) {
-					Entry entry(path, kind, token);
-					AddEntry(entry);
+				/// <param name="kind">Classified kind of the value</param>
+				/// <param name="value">Value token, without blanks or comments around</param>
+				/// <param name="length">Value token length</param>
+				/// <param name="output">Decoded payload, untouched unless the result is Sucess</param>
+				/// <returns>Sucess, Overflow, the format error or NotValidTryNext for kinds without a scalar</returns>
+				static TOMLResultStatus Decode(Kind kind, const char* value, int length, TOMLScalar& output) {
+					TOMLResultStatus result(NotValidTryNext);
+					if (kind == Kind::Bool) {
+						bool flag = false;
+						result = Bool(value, length, flag);
+						output.integer = flag ? 1 : 0;
+					}
+					else if (kind == Kind::Integer) {
+						int64_t integer = 0;
+						result = Integer(value, length, integer);
+						output.integer = integer;
+					}
+					else if (kind == Kind::Double) {
+						double decimal = 0.0;
+						result = Decimal(value, length, decimal);
+						output.decimal = decimal;
+					}
+					output.decoded = result.StatusCode == Sucess;
+					return result;
+				}
+			};
+			/// <summary>
+			/// Zero-copy view of an array value. Elements are found lazily on iteration, strings, nested
+			/// arrays and inline tables are returned whole, as their raw tokens.
+			/// </summary>
+			class ArrayView {
+				const char* data;
+				int length;
+				int cursor;
+				static bool IsBlank(char c) {
+					return c == ' ' || c == '\t' || c == '\r' || c == '\n';
 				}
 				/// <summary>
-				///  [Generation only] Register an specified entry (2)
+				/// Offset past the string starting at start, or length if it is not closed.
 				/// </summary>
-				/// <param name="path"></param>
-				/// <param name="kind"></param>
-				/// <param name="token"></param>
-				void AddEntryAndPath(PathName& path, Kind kind, TOMLToken token) {
-					for (int i = 0; i < idxPaths; i++) {
-						if (Paths[i].GetContents() == path.GetContents()) {
-							AddEntry(&(Paths[i]), kind, token);
-							return;
+				static size_t SkipString(const char* text, size_t start, size_t length) {
+					char quote = text[start];
+					size_t i = start + 1;
+					while (i < length && text[i] != quote) {
+						if (quote == '"' && text[i] == '\\') {
+							i++;
 						}
+						i++;
 					}
-					Paths[idxPaths] = path;
-					AddEntry(&Paths[idxPaths], kind, token);
-					idxPaths++;
+					return i < length ? i + 1 : length;
 				}
+			public:
+				ArrayView() : data(nullptr), length(0), cursor(0) {}
 				/// <summary>
-				/// [Generation Only] Register an path if isnt already
+				/// View of an array value token, empty if the token is not an array.
 				/// </summary>
-				/// <param name="path"></param>
-				void AddPath(PathName& path) {
-					PathName* iterator = this->Paths;
-
-					for (int i = 0; i < idxPaths; i++) {
-						if (!iterator[i].IsRoot()) {
-
-							if (strncmp(iterator[i].GetContents(), path.GetContents(), Text::IndexOf(iterator[i].GetContents(), ']')) == 0) {
-								return;
+				explicit ArrayView(TOMLToken value) : data(nullptr), length(0), cursor(0) {
+					if (value.contents && value.length > 0 && value.contents[0] == '[') {
+						bool closed;
+						size_t span = Span(value.contents, (size_t)value.length, closed);
+						data = value.contents + 1;
+						length = (int)span - (closed ? 2 : 1);
+					}
+				}
+				/// <summary>
+				/// Length of the array starting at data, up to and including its closing bracket. Brackets
+				/// in strings and comments are ignored, so the array may go on over several lines.
+				/// </summary>
+				/// <param name="closed">False if the content ends before the closing bracket, the whole length is returned then</param>
+				static size_t Span(const char* text, size_t length, bool& closed) {
+					int depth = 0;
+					size_t i = 0;
+					while (i < length) {
+						char c = text[i];
+						if (c == '"' || c == '\'') {
+							i = SkipString(text, i, length);
+							continue;
+						}
+						if (c == '#') {
+							while (i < length && text[i] != '\n') {
+								i++;
 							}
+							continue;
+						}
+						if (c == '[' || c == '{') {
+							depth++;
+						}
+						else if ((c == ']' || c == '}') && --depth == 0) {
+							closed = true;
+							return i + 1;
 						}
+						i++;
 					}
-					Paths[idxPaths++] = path;
+					closed = false;
+					return length;
 				}
 				/// <summary>
-				/// [Generation only] Register an comment
+				/// Moves to the next element.
 				/// </summary>
-				/// <param name="tokenStart"></param>
-				/// <param name="tokenLength"></param>
-				void AddComment(int tokenStart, int tokenLength) {
-					Commentaries[idxComments].index = tokenStart;
-					Commentaries[idxComments].length= tokenLength;
-					idxComments++;
+				/// <param name="element">Trimmed element token</param>
+				/// <returns>False past the last element</returns>
+				bool Next(TOMLToken& element) {
+					while (cursor < length) {
+						char c = data[cursor];
+						if (IsBlank(c) || c == ',') {
+							cursor++;
+						}
+						else if (c == '#') {
+							while (cursor < length && data[cursor] != '\n') {
+								cursor++;
+							}
+						}
+						else {
+							break;
+						}
+					}
+					if (cursor >= length) {
+						return false;
+					}
+					int start = cursor;
+					int depth = 0;
+					while (cursor < length) {
+						char c = data[cursor];
+						if (c == '"' || c == '\'') {
+							cursor = (int)SkipString(data, (size_t)cursor, (size_t)length);
+							continue;
+						}
+						if (c == '[' || c == '{') {
+							depth++;
+						}
+						else if (c == ']' || c == '}') {
+							depth--;
+						}
+						else if (depth <= 0 && (c == ',' || c == '#' || c == '\n')) {
+							break;
+						}
+						cursor++;
+					}
+					int end = cursor;
+					while (end > start && IsBlank(data[end - 1])) {
+						end--;
+					}
+					element.contents = const_cast<char*>(data + start);
+					element.length = end - start;
+					return true;
 				}
 				/// <summary>
-				/// [Generation only] Set the originary data.
+				/// Restarts the iteration.
 				/// </summary>
-				/// <param name="data">Char array</param>
-				void SetData(char* data) {
-					this->Data = data;
+				void Reset() {
+					cursor = 0;
 				}
-				
 				/// <summary>
-				/// Destroy this instance
+				/// Count of the elements, found by a separate iteration.
 				/// </summary>
-				void Destroy() {
-					delete[] Paths;
-					delete[] Entries;
-					delete[] Commentaries;
-					sys::memset(Commentaries, 0, sizeof(CommentEntry) * idxComments);
-					sys::memset(Paths, 0, sizeof(PathName) * idxPaths);
-					sys::memset(Entries, 0, sizeof(Entry) * idxEntries);
+				int Count() const {
+					ArrayView copy(*this);
+					copy.Reset();
+					TOMLToken element;
+					int count = 0;
+					while (copy.Next(element)) {
+						count++;
+					}
+					return count;
 				}
-				void Initialize(int paths, int entries, int comments) {
-					Paths = new PathName[paths];
-					Entries = new Entry[paths];
-					Commentaries = new CommentEntry[paths];
+				/// <summary>
+				/// Decodes integer elements into a contiguous buffer. Digit runs are read eight at a time,
+				/// elements outside the plain decimal form go through ScalarDecoder::Integer.
+				/// </summary>
+				/// <param name="output">Target buffer</param>
+				/// <param name="capacity">Target buffer element count</param>
+				/// <param name="outputStatus">Nullable. The first error along with the element index, Overflow with
+				/// the capacity if the buffer is too small</param>
+				/// <returns>Count of the elements written</returns>
+				int DecodeIntegers(int64_t* output, int capacity, TOMLResultStatus* outputStatus) const {
+					ArrayView copy(*this);
+					copy.Reset();
+					TOMLToken element;
+					int count = 0;
+					while (copy.Next(element)) {
+						if (count == capacity) {
+							return Fail(outputStatus, TOMLResultStatus(Overflow, capacity), count);
+						}
+						if (!DigitRun::Integer(element.contents, element.length, output[count])) {
+							TOMLResultStatus result = ScalarDecoder::Integer(element.contents, element.length, output[count]);
+							if (result.StatusCode != Sucess) {
+								return Fail(outputStatus, TOMLResultStatus(result.StatusCode, count), count);
+							}
+						}
+						count++;
+					}
+					if (outputStatus) {
+						*outputStatus = TOMLResultStatus(Sucess);
+					}
+					return count;
 				}
 				/// <summary>
-				/// Let him destroy this instance manually.
+				/// Decodes decimal (or integer) elements into a contiguous buffer. Digit runs are read eight at
+				/// a time and exactly representable values skip Double::Parse.
 				/// </summary>
-				~Root() {
-					__nop();
+				/// <param name="output">Target buffer</param>
+				/// <param name="capacity">Target buffer element count</param>
+				/// <param name="outputStatus">Nullable, as in DecodeIntegers</param>
+				/// <returns>Count of the elements written</returns>
+				int DecodeDecimals(double* output, int capacity, TOMLResultStatus* outputStatus) const {
+					ArrayView copy(*this);
+					copy.Reset();
+					TOMLToken element;
+					int count = 0;
+					while (copy.Next(element)) {
+						if (count == capacity) {
+							return Fail(outputStatus, TOMLResultStatus(Overflow, capacity), count);
+						}
+						if (!DigitRun::Decimal(element.contents, element.length, output[count])) {
+							TOMLResultStatus result = ScalarDecoder::Decimal(element.contents, element.length, output[count]);
+							if (result.StatusCode != Sucess) {
+								return Fail(outputStatus, TOMLResultStatus(result.StatusCode, count), count);
+							}
+						}
+						count++;
+					}
+					if (outputStatus) {
+						*outputStatus = TOMLResultStatus(Sucess);
+					}
+					return count;
+				}
+			private:
+				static int Fail(TOMLResultStatus* outputStatus, const TOMLResultStatus& status, int count) {
+					if (outputStatus) {
+						*outputStatus = status;
+					}
+					return count;
 				}
 			};
-			typedef HResult TOMLHResultOrPtr;
-
 			/// <summary>
-/// Encapsulates a dynamic instance of a TOML enumeration
-/// </summary>
-			class TOML {
+			/// Default entry key-value pair holder model. 
+			/// </summary>
+			class Entry {
 			public:
 				/// <summary>
-				/// Quick factory initialization
+				/// [Not trivial] Storage of this element's path on the root document.
 				/// </summary>
-				/// <param name="data">Pointer to the raw TOML data</param>
-				TOML(char* data) {
-					Contents.ConstructorInit();  // Initialize the instance of Root container
-					Contents->SetData(data);     // Set the provided TOML data to the instance
-				}
-
+				PathName* path;
 				/// <summary>
-				/// Default constructor, no initialization.
+				/// [Not Trivial] Entry value descriptor, its token is the trimmed value without inline comments.
 				/// </summary>
-				TOML() {
-
-				}
-
+				Value value;
 				/// <summary>
-				/// Dynamic and shared instance of the root container.
+				/// [Not Trivial] Key token.
 				/// </summary>
-				System::Instance<Root> Contents;
-
+				TOMLToken key;
 				/// <summary>
-				/// Get the count of the collected entries within the TOML structure.
+				/// Value decoded at parse time, see ParseOptions::eagerDecode.
 				/// </summary>
-				/// <returns>Number of entries in the TOML</returns>
-				size_t Count() {
-					if (Contents.NotNull()) {
-						return Contents->getLength();  // Returns the length of the entries in the root container
+				TOMLScalar scalar;
+				/// <summary>
+				/// Splits a line token into its key and trimmed value tokens.
+				/// </summary>
+				/// <param name="line">Line token, starting at the key</param>
+				static void SplitLine(TOMLToken line, TOMLToken& key, TOMLToken& value) {
+					key.contents = line.contents;
+					key.length = 0;
+					value.contents = line.contents;
+					value.length = 0;
+					if (!line.contents) {
+						return;
 					}
-					return 0;
+					while (key.length < line.length) {
+						char c = line.contents[key.length];
+						if (c == '=' || c == ' ' || c == '\t') {
+							break;
+						}
+						key.length++;
+					}
+					int start = key.length;
+					while (start < line.length && line.contents[start] != '=') {
+						start++;
+					}
+					start = start < line.length ? start + 1 : line.length;
+					while (start < line.length && line.contents[start] == ' ') {
+						start++;
+					}
+					int end = line.length;
+					while (end > start && (line.contents[end - 1] == ' ' || line.contents[end - 1] == '\t')) {
+						end--;
+					}
+					value.contents = line.contents + start;
+					value.length = end - start;
 				}
 				/// <summary>
-				/// Get the used memory size by the root container of the document contents.
+				/// [Factory] Build specifically this instance
 				/// </summary>
-				/// <returns>size_t</returns>
-				size_t SizeOf() {
-					return
-						Contents->getLength() * sizeof(Entry) |
-						Contents->commentCount() * sizeof(CommentEntry) |
-						Contents->pathCount() * sizeof(PathName) | 
-						sizeof(Root);
+				/// <param name="path"></param>
+				/// <param name="kind"></param>
+				/// <param name="token">Whole line token, split into the key and value tokens</param>
+				Entry(PathName* path, Kind kind, TOMLToken token) {
+					this->path = path;
+					value.kind = kind;
+					SplitLine(token, key, value.token);
+					scalar = TOMLScalar::None();
 				}
 				/// <summary>
-				/// Index accessor to retrieve the entry at a specific index.
+				/// [Factory] Build specifically this instance along with its decoded value.
 				/// </summary>
-				/// <param name="index">Index of the entry</param>
-				/// <returns>A reference to the Entry object at the given index</returns>
-				Entry& operator [](size_t index) {
-					return Contents->Entries[index];  // Access the entry at the specified index
+				Entry(PathName* path, Kind kind, TOMLToken token, TOMLScalar scalar) {
+					this->path = path;
+					value.kind = kind;
+					SplitLine(token, key, value.token);
+					this->scalar = scalar;
 				}
-
 				/// <summary>
-				/// Get the original text data that was used to initialize the TOML object.
+				/// [Factory] Build specifically this instance from its exact tokens.
 				/// </summary>
-				/// <returns>Pointer to the raw data (nullable)</returns>
-				char* GetText() {
-					return Contents->Data;  // Return the original data used for parsing
+				Entry(PathName* path, Kind kind, TOMLToken key, TOMLToken valueToken, TOMLScalar scalar) {
+					this->path = path;
+					value.kind = kind;
+					value.token = valueToken;
+					this->key = key;
+					this->scalar = scalar;
 				}
-
 				/// <summary>
-				/// Find a path by its name within the TOML structure.
+				/// [Factory] Build this instance as an incompleted or in-processing entry.
 				/// </summary>
-				/// <param name="name">Name of the path to search for</param>
-				/// <returns>Pointer to the matching PathName object or nullptr if not found</returns>
-				PathName* FindPathByName(const char* name) {
-					forIndexIn(Contents->pathCount()) {  // Loop through all paths
-						if (Contents->Paths[i].Equals(name)) {  // Compare names
-							return &Contents->Paths[i];  // Return the matching path
-						}
-					}
-					return nullptr;  // Return null if no path matches
+				Entry() {
+					value.Build();
+					key.contents = nullptr;
+					key.length = 0;
+					scalar = TOMLScalar::None();
 				}
-
 				/// <summary>
-				/// Find an entry by its full path within the TOML structure.
+				/// Outputs the valuable text of this string. The buffer must hold the value and a terminator.
 				/// </summary>
-				/// <param name="fullpath">Full path string to the entry (e.g., "path/to/entry")</param>
-				/// <returns>Pointer to the matching Entry object or nullptr if not found</returns>
-				Entry* FindEntryByPath(const char* fullpath) {
-					if (!fullpath) {  // Ensure fullpath is valid
-						return nullptr;
+				/// <param name="buffer"></param>
+				bool Output(char* buffer) {
+					if (!value.token.contents) {
+						return false;
 					}
-					if (sys::strlen(fullpath) > 0) {
-						Entry* result = nullptr;
-						if (Text::IndexOf(fullpath, '/') != -1) {  // Check if the path contains a slash (indicating a hierarchical path)
-							char pathBuff[64];
-							char entryName[64];
-							if (Text::SplitLineByKey(fullpath, '/', pathBuff, entryName)) {  // Split the path and entry name
-								for (int i = 0; i < Contents->getLength(); i++) {  // Loop through the entries
-									if (safest_compare(Contents->Entries[i].value.token.contents, entryName) &&
-										Contents->Entries[i].path->Equals(pathBuff)) {
-										result = &Contents->Entries[i];  // Set result if entry and path match
-									}
-								}
-							}
-							Marshal::Clear(pathBuff);  // Clear the buffer for security
-							Marshal::Clear(entryName);
-							return result;  // Return the found entry
-						}
-						else {
-							for (int i = 0; i < Contents->getLength(); i++) {  // If no slash, look for a direct entry match
-								if (safest_compare(Contents->Entries[i].value.token.contents, fullpath)) {
-									result = &Contents->Entries[i];
-								}
-							}
-							return result;  // Return the found entry
-						}
+					Marshal::Copy(value.token.contents, buffer, value.token.length);
+					buffer[value.token.length] = 0;
+					return true;
+				}
+				/// <summary>
+				/// Outputs the valuable text of this string, null terminated.
+				/// </summary>
+				/// <param name="buffer">Target buffer</param>
+				/// <param name="capacity">Target buffer size</param>
+				/// <returns>False if there is no value or it does not fit, the buffer is untouched then</returns>
+				bool Output(char* buffer, int capacity) {
+					if (!value.token.contents || value.token.length >= capacity) {
+						return false;
 					}
-					return nullptr;  // Return null if no entry matches
+					return Output(buffer);
 				}
-
 				/// <summary>
-				/// Destroy this instance of TOML, clearing its contents.
+				/// Elements of an array value, empty for other kinds.
 				/// </summary>
-				void Destroy() {
-					Contents->Destroy();  // Clear the root container
-					Contents.Destroy();   // Destroy the instance itself
+				ArrayView getArray() const {
+					return ArrayView(value.token);
 				}
-
 				/// <summary>
-				/// Destructor for TOML instance.
+				/// Zero-copy view of the trimmed value, pointing into the document data.
 				/// </summary>
-				~TOML() {
-					__nop();  // No operation, placeholder for any future cleanup
-				};
-			};
-
-			class Parser {
-			public:
-
-				// [Obsolete]
-				template <typename prim>
-				static bool IsFlaggedBy(prim& integerType, uint16_t bits) {
-					return (integerType & bits) != 0;
+				/// <returns>Token, not null terminated</returns>
+				TOMLToken getView() const {
+					return value.token;
 				}
-				// [Obsolete]
-				template <typename prim>
-				static void SetFlag(prim& integerType, uint16_t bits, bool switchable) {
-					if (switchable)
-						integerType |= bits;
-					else
-						integerType &= ~bits;
+				/// <summary>
+				/// Checks if this instance belongs to the document's root path.
+				/// </summary>
+				/// <returns>Boolean</returns>
+				bool isRootPath() {
+					if (path) {
+						return path->IsRoot();
+					}
+					return path == nullptr;
 				}
-
-				static Boolean IsKeyValidCharacter(Char c) {
-					return
-						c.IsLetter() ||
-						c.IsDigit() ||
-						c.Equals('-') ||
-						c.Equals('_');
+				/// <summary>
+				/// Key token of this entry.
+				/// </summary>
+				/// <returns>Token into the document data</returns>
+				TOMLToken getKey() const {
+					return key;
 				}
 				/// <summary>
-				/// Parses the valuable decimal (float/double) side of the equation.
+				/// Value as a 64-bit integer, decimals are truncated.
 				/// </summary>
-				/// <param name="startIndex">Reference index of the line, for the final token to be stored in output</param>
-				/// <param name="segmentIterator">Data accessor iterator starting after the equal symbol.</param>
-				/// <param name="output">Output structure space for storing resulting analysis if operation completes.</param>
+				int64_t getInt64() {
+					if (scalar.decoded) {
+						return value.kind == Double ? (int64_t)scalar.decimal : scalar.integer;
+					}
+					int64_t integer = 0;
+					if (ScalarDecoder::Integer(value.token.contents, value.token.length, integer).StatusCode == Sucess) {
+						return integer;
+					}
+					return (int64_t)getDecimal();
+				}
+				int32_t getInt() {
+					if (scalar.decoded) {
+						return value.kind == Double ? (int32_t)scalar.decimal : (int32_t)scalar.integer;
+					}
+					int64_t integer = 0;
+					if (ScalarDecoder::Integer(value.token.contents, value.token.length, integer).StatusCode == Sucess) {
+						return (int32_t)integer;
+					}
+					return (int32_t)getDecimal();
+				}
+				double getDecimal() {
+					if (scalar.decoded) {
+						return value.kind == Double ? scalar.decimal : (double)scalar.integer;
+					}
+					double decimal = 0.0;
+					if (ScalarDecoder::Decimal(value.token.contents, value.token.length, decimal).StatusCode == Sucess) {
+						return decimal;
+					}
+					return 0.0;
+				}
+				float getFloat() {
+					if (scalar.decoded) {
+						return value.kind == Double ? (float)scalar.decimal : (float)scalar.integer;
+					}
+					return (float)getDecimal();
+				}
+				signed char getBoolean() {
+					if (scalar.decoded) {
+						return value.kind == Double ? scalar.decimal != 0.0 : scalar.integer != 0;
+					}
+					bool flag = false;
+					ScalarDecoder::Bool(value.token.contents, value.token.length, flag);
+					return flag;
+				}
+			};
+			/// <summary>
+			/// Comment entry holder class. Alias for an token.
+			/// </summary>
+			class CommentEntry {
+			public:
+				int index;
+				int length;
+				CommentEntry() {}
+				CommentEntry(int c, int l) : index(c), length(l) {}
+			};
+			/// <summary>
+			/// Open-addressing (linear probing) hash index mapping a 32-bit hash to an element index.
+			/// Slots only hold the hash and the target, the caller verifies the candidates.
+			/// </summary>
+			class HashIndex {
+			public:
+				struct Slot {
+					uint32_t hash;
+					int32_t target;
+				};
+			private:
+				Slot* slots = nullptr;
+				uint32_t mask = 0;
+				int count = 0;
+				bool owned = false;
+			public:
+				/// <summary>
+				/// Slot count needed to hold the specified element count under 50% load.
+				/// </summary>
+				static int CapacityFor(int expected) {
+					uint32_t capacity = 8;
+					while (capacity < (uint32_t)expected * 2) {
+						capacity <<= 1;
+					}
+					return (int)capacity;
+				}
+				/// <summary>
+				/// [Factory] Allocates an empty index able to hold the specified element count under 50% load.
+				/// </summary>
+				/// <param name="expected">Expected element count</param>
+				void Initialize(int expected) {
+					int capacity = CapacityFor(expected);
+					Initialize(new Slot[capacity], capacity);
+					owned = true;
+				}
+				/// <summary>
+				/// [Factory] Builds an empty index over caller owned slots.
+				/// </summary>
+				/// <param name="storage">Slot storage, CapacityFor(expected) slots</param>
+				/// <param name="capacity">Slot count, a power of two</param>
+				void Initialize(Slot* storage, int capacity) {
+					slots = storage;
+					mask = (uint32_t)capacity - 1;
+					owned = false;
+					Clear();
+				}
+				/// <summary>
+				/// [Factory] Uses slots that already hold an index, such as those of a snapshot image.
+				/// The slots may be read-only, the index must not be modified then.
+				/// </summary>
+				/// <param name="storage">Filled slot storage</param>
+				/// <param name="capacity">Slot count, a power of two</param>
+				/// <param name="length">Count of the indexed elements</param>
+				void Attach(const Slot* storage, int capacity, int length) {
+					slots = const_cast<Slot*>(storage);
+					mask = (uint32_t)capacity - 1;
+					owned = false;
+					count = length;
+				}
+				const Slot* getSlots() const {
+					return slots;
+				}
+				/// <summary>
+				/// Removes every element, keeping the slots.
+				/// </summary>
+				void Clear() {
+					for (uint32_t i = 0; slots && i <= mask; i++) {
+						slots[i].hash = 0;
+						slots[i].target = -1;
+					}
+					count = 0;
+				}
+				/// <summary>
+				/// Starts a probe sequence for the specified hash.
+				/// </summary>
+				/// <param name="hash">Element hash</param>
+				/// <param name="cursor">Probe cursor, pass it back to Next</param>
+				/// <returns>First candidate index or -1 if none</returns>
+				int First(uint32_t hash, uint32_t& cursor) const {
+					if (!slots) {
+						return -1;
+					}
+					cursor = hash & mask;
+					return Next(hash, cursor);
+				}
+				/// <summary>
+				/// Continues a probe sequence, returning the next candidate with an equal hash.
+				/// </summary>
+				/// <returns>Candidate index or -1 when the sequence reaches an empty slot</returns>
+				int Next(uint32_t hash, uint32_t& cursor) const {
+					while (slots[cursor].target != -1) {
+						const Slot& slot = slots[cursor];
+						cursor = (cursor + 1) & mask;
+						if (slot.hash == hash) {
+							return slot.target;
+						}
+					}
+					return -1;
+				}
+				/// <summary>
+				/// Hints the cache about the first slot probed for the specified hash, ahead of First.
+				/// </summary>
+				void Prefetch(uint32_t hash) const {
+#if defined(__GNUC__)
+					if (slots) {
+						__builtin_prefetch(&slots[hash & mask]);
+					}
+#endif
+				}
+				/// <summary>
+				/// Inserts a new element. The caller must have ruled out an equal element already.
+				/// </summary>
+				void Insert(uint32_t hash, int target) {
+					uint32_t cursor = hash & mask;
+					while (slots[cursor].target != -1) {
+						cursor = (cursor + 1) & mask;
+					}
+					slots[cursor].hash = hash;
+					slots[cursor].target = target;
+					count++;
+				}
+				/// <summary>
+				/// Replaces the target of the slot holding the specified one.
+				/// </summary>
+				void Replace(uint32_t hash, int previous, int target) {
+					uint32_t cursor = hash & mask;
+					while (slots[cursor].target != -1) {
+						if (slots[cursor].hash == hash && slots[cursor].target == previous) {
+							slots[cursor].target = target;
+							return;
+						}
+						cursor = (cursor + 1) & mask;
+					}
+				}
+				/// <summary>
+				/// Get the count of the indexed elements.
+				/// </summary>
+				int getLength() const {
+					return count;
+				}
+				/// <summary>
+				/// Get the count of the allocated slots.
+				/// </summary>
+				int getCapacity() const {
+					return slots ? (int)(mask + 1) : 0;
+				}
+				void Destroy() {
+					if (owned) {
+						delete[] slots;
+					}
+					slots = nullptr;
+					mask = 0;
+					count = 0;
+					owned = false;
+				}
+			};
+			/// <summary>
+			/// Bump allocator over a single heap block. Everything carved from it is released at once.
+			/// </summary>
+			class Arena {
+				byte* block = nullptr;
+				size_t capacity = 0;
+				size_t used = 0;
+			public:
+				static const size_t Alignment = 16;
+				static size_t Align(size_t size) {
+					return (size + Alignment - 1) & ~(Alignment - 1);
+				}
+				/// <summary>
+				/// Bytes taken by an array once aligned, for sizing the block.
+				/// </summary>
+				template <typename T>
+				static size_t SizeOf(int count) {
+					return Align(sizeof(T) * (size_t)count);
+				}
+				/// <summary>
+				/// [Factory] Allocates the block.
+				/// </summary>
+				void Initialize(size_t size) {
+					block = size ? new byte[size] : nullptr;
+					capacity = size;
+					used = 0;
+				}
+				/// <summary>
+				/// Carves an aligned region from the block.
+				/// </summary>
+				/// <returns>Region start or nullptr if the block is exhausted</returns>
+				void* Allocate(size_t size) {
+					size = Align(size);
+					if (used + size > capacity) {
+						return nullptr;
+					}
+					void* region = block + used;
+					used += size;
+					return region;
+				}
+				/// <summary>
+				/// Carves an array of default constructed elements from the block.
+				/// </summary>
+				template <typename T>
+				T* AllocateArray(int count) {
+					T* array = (T*)Allocate(sizeof(T) * (size_t)count);
+					if (array) {
+						for (int i = 0; i < count; i++) {
+							new (&array[i]) T();
+						}
+					}
+					return array;
+				}
+				size_t getCapacity() const {
+					return capacity;
+				}
+				size_t getUsed() const {
+					return used;
+				}
+				/// <summary>
+				/// Releases the block with a single free. Elements are not destructed.
+				/// </summary>
+				/// <param name="wipe">Clears the used bytes before releasing them</param>
+				void Destroy(bool wipe) {
+					if (block && wipe) {
+						Marshal::Clear(block, used);
+					}
+					delete[] block;
+					block = nullptr;
+					capacity = 0;
+					used = 0;
+				}
+			};
+			/// <summary>
+			/// Read-only view of a whole file. Files are memory mapped where the platform allows it and
+			/// read into an owned buffer otherwise. The text is not null terminated.
+			/// </summary>
+			class MappedFile {
+				char* data = nullptr;
+				size_t length = 0;
+				MappedFile(const MappedFile&);
+				MappedFile& operator=(const MappedFile&);
+			public:
+				MappedFile() {
+				}
+				~MappedFile() {
+					Close();
+				}
+				enum Flags {
+					/// <summary>
+					/// Prefault the whole mapping when it is created (MAP_POPULATE).
+					/// </summary>
+					Populate = 1,
+					/// <summary>
+					/// Advise the kernel the mapping is read front to back (MADV_SEQUENTIAL).
+					/// </summary>
+					Sequential = 2,
+					/// <summary>
+					/// Advise the kernel the whole mapping is needed soon, so it is read in the background (MADV_WILLNEED).
+					/// </summary>
+					WillNeed = 4,
+				};
+				/// <summary>
+				/// Opens and maps the specified file.
+				/// </summary>
+				/// <param name="path">File path</param>
+				/// <param name="flags">Combination of Flags</param>
+				/// <returns>True if sucess.</returns>
+				Boolean Open(const char* path, int flags) {
+					Close();
+					if (!path) {
+						return false;
+					}
+#if TOML_MAPPED_FILES
+					int descriptor = open(path, O_RDONLY);
+					if (descriptor < 0) {
+						return false;
+					}
+					struct stat status;
+					if (fstat(descriptor, &status) != 0) {
+						close(descriptor);
+						return false;
+					}
+					length = (size_t)status.st_size;
+					if (length > 0) {
+						int mapFlags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+						if (flags & Populate) {
+							mapFlags |= MAP_POPULATE;
+						}
+#endif
+						void* view = mmap(nullptr, length, PROT_READ, mapFlags, descriptor, 0);
+						if (view == MAP_FAILED) {
+							close(descriptor);
+							length = 0;
+							return false;
+						}
+						if (flags & Sequential) {
+							madvise(view, length, MADV_SEQUENTIAL);
+						}
+						if (flags & WillNeed) {
+							madvise(view, length, MADV_WILLNEED);
+						}
+						data = (char*)view;
+					}
+					close(descriptor);
+					return true;
+#else
+					FILE* file = fopen(path, "rb");
+					if (!file) {
+						return false;
+					}
+					fseek(file, 0, SEEK_END);
+					long size = ftell(file);
+					fseek(file, 0, SEEK_SET);
+					if (size < 0) {
+						fclose(file);
+						return false;
+					}
+					length = (size_t)size;
+					if (length > 0) {
+						data = new char[length];
+						if (fread(data, 1, length, file) != length) {
+							fclose(file);
+							Close();
+							return false;
+						}
+					}
+					fclose(file);
+					return true;
+#endif
+				}
+				/// <summary>
+				/// Releases the mapping or the owned buffer.
+				/// </summary>
+				void Close() {
+					if (data) {
+#if TOML_MAPPED_FILES
+						munmap(data, length);
+#else
+						delete[] data;
+#endif
+					}
+					data = nullptr;
+					length = 0;
+				}
+				/// <summary>
+				/// Takes over the mapping of another file, which is left closed. The current mapping is released.
+				/// </summary>
+				void Take(MappedFile& other) {
+					if (&other == this) {
+						return;
+					}
+					Close();
+					data = other.data;
+					length = other.length;
+					other.data = nullptr;
+					other.length = 0;
+				}
+				char* GetData() const {
+					return data;
+				}
+				size_t getLength() const {
+					return length;
+				}
+			};
+			/// <summary>
+			/// Growable storage made of fixed size chunks. Growing never moves the stored elements,
+			/// so parsing can append without knowing the final counts in advance.
+			/// </summary>
+			template <typename T, int ChunkSize = 256>
+			class ChunkedStorage {
+				T** chunks = nullptr;
+				int chunkCount = 0;
+				int chunkCapacity = 0;
+				int length = 0;
+			public:
+				/// <summary>
+				/// Appends an element, allocating a new chunk when the last one is full.
+				/// </summary>
+				/// <returns>Index of the element</returns>
+				int Push(const T& element) {
+					if (length == chunkCount * ChunkSize) {
+						if (chunkCount == chunkCapacity) {
+							int capacity = chunkCapacity ? chunkCapacity * 2 : 8;
+							T** grown = new T*[capacity];
+							if (chunks) {
+								Marshal::Copy(chunks, grown, sizeof(T*) * chunkCount);
+								delete[] chunks;
+							}
+							chunks = grown;
+							chunkCapacity = capacity;
+						}
+						chunks[chunkCount++] = new T[ChunkSize];
+					}
+					chunks[length / ChunkSize][length % ChunkSize] = element;
+					return length++;
+				}
+				T& operator [](int index) {
+					return chunks[index / ChunkSize][index % ChunkSize];
+				}
+				const T& operator [](int index) const {
+					return chunks[index / ChunkSize][index % ChunkSize];
+				}
+				/// <summary>
+				/// Get the count of the stored elements.
+				/// </summary>
+				int getLength() const {
+					return length;
+				}
+				/// <summary>
+				/// Removes every element, keeping the chunks for the next ones.
+				/// </summary>
+				void Clear() {
+					length = 0;
+				}
+				void Destroy() {
+					for (int i = 0; i < chunkCount; i++) {
+						delete[] chunks[i];
+					}
+					delete[] chunks;
+					chunks = nullptr;
+					chunkCount = 0;
+					chunkCapacity = 0;
+					length = 0;
+				}
+				~ChunkedStorage() {
+					Destroy();
+				}
+			};
+			/// <summary>
+			/// Runs a batch of independent tasks on short lived worker threads. Every worker, the calling
+			/// thread included, claims the next pending task from a shared counter until none is left, so
+			/// idle workers keep taking work while a slow task is still running. Without thread support or
+			/// when a worker cannot be started, the remaining tasks simply run on the calling thread.
+			/// </summary>
+			class TaskPool {
+			public:
+				typedef void (*Task)(void* context, int index);
+				static const int MaxWorkers = 32;
+			private:
+				struct Batch {
+					Task task;
+					void* context;
+					int count;
+					volatile int next;
+				};
+				static int Claim(Batch* batch) {
+#if defined(TOML_THREADS)
+					return __sync_fetch_and_add(&batch->next, 1);
+#else
+					return batch->next++;
+#endif
+				}
+				static void Drain(Batch* batch) {
+					for (int index = Claim(batch); index < batch->count; index = Claim(batch)) {
+						batch->task(batch->context, index);
+					}
+				}
+#if defined(__CELLOS_LV2__)
+				static void WorkerEntry(uint64_t argument) {
+					Drain((Batch*)(uintptr_t)argument);
+					sys_ppu_thread_exit(0);
+				}
+#elif defined(TOML_THREADS)
+				static void* WorkerEntry(void* argument) {
+					Drain((Batch*)argument);
+					return nullptr;
+				}
+#endif
+			public:
+				/// <summary>
+				/// Runs task(context, i) for every i in [0, count) and waits for all of them.
+				/// </summary>
+				/// <param name="workers">Threads to use, the calling thread included</param>
+				/// <returns>Threads that actually took part</returns>
+				static int Run(Task task, void* context, int count, int workers) {
+					Batch batch = { task, context, count, 0 };
+					if (workers > MaxWorkers) {
+						workers = MaxWorkers;
+					}
+					if (workers > count) {
+						workers = count;
+					}
+					int started = 0;
+#if defined(__CELLOS_LV2__)
+					sys_ppu_thread_t threads[MaxWorkers];
+					for (int i = 1; i < workers; i++) {
+						if (sys_ppu_thread_create(&threads[started], WorkerEntry, (uint64_t)(uintptr_t)&batch, 1001, 0x4000, SYS_PPU_THREAD_CREATE_JOINABLE, "toml_worker") == CELL_OK) {
+							started++;
+						}
+					}
+#elif defined(TOML_THREADS)
+					pthread_t threads[MaxWorkers];
+					for (int i = 1; i < workers; i++) {
+						if (pthread_create(&threads[started], nullptr, WorkerEntry, &batch) == 0) {
+							started++;
+						}
+					}
+#endif
+					Drain(&batch);
+#if defined(__CELLOS_LV2__)
+					for (int i = 0; i < started; i++) {
+						uint64_t exitStatus;
+						sys_ppu_thread_join(threads[i], &exitStatus);
+					}
+#elif defined(TOML_THREADS)
+					for (int i = 0; i < started; i++) {
+						pthread_join(threads[i], nullptr);
+					}
+#endif
+					return started + 1;
+				}
+			};
+			/// <summary>
+			/// Tables of a document arranged by their dotted names: [a.b.c] is a child of a.b, itself a
+			/// child of a, whether or not a and a.b have headers of their own. The entries are listed in
+			/// depth first order, so the entries of a table and of its whole subtree are each a contiguous
+			/// range of Order. Names given to Find may separate their parts with '.' or '/'.
+			/// </summary>
+			class TableTree {
+			public:
+				struct Node {
+					int32_t parent;
+					int32_t firstChild;
+					int32_t nextSibling;
+					int32_t lastChild;
+					/// <summary>
+					/// Table ID in Root::Paths, -1 for a table only implied by deeper headers.
+					/// </summary>
+					int32_t path;
+					/// <summary>
+					/// Path whose name starts with the name of this node, -1 for the root node.
+					/// </summary>
+					int32_t source;
+					/// <summary>
+					/// Length of the full dotted name, and start of its last part within it.
+					/// </summary>
+					int32_t nameLength;
+					int32_t segment;
+					/// <summary>
+					/// Range of the own entries of the table in Order, [first, first + count).
+					/// </summary>
+					int32_t first;
+					int32_t count;
+					/// <summary>
+					/// End of the range of the whole subtree in Order, which starts at first.
+					/// </summary>
+					int32_t end;
+				};
+				/// <summary>
+				/// Contiguous run of entry indexes, usable with range-based for.
+				/// </summary>
+				struct EntryRange {
+					const int32_t* first;
+					const int32_t* last;
+					const int32_t* begin() const {
+						return first;
+					}
+					const int32_t* end() const {
+						return last;
+					}
+					int getLength() const {
+						return (int)(last - first);
+					}
+				};
+				/// <summary>
+				/// Node of the document root, the parent of the top level tables.
+				/// </summary>
+				static const int RootNode = 0;
+			private:
+				Node* nodes = nullptr;
+				int nodeCount = 0;
+				int32_t* order = nullptr;
+				/// <summary>
+				/// Node of each path. Paths whose names only differ by '.' and '/' share a node and its entries.
+				/// </summary>
+				int32_t* pathNodes = nullptr;
+				HashIndex nodeIndex;
+				const PathName* paths = nullptr;
+				/// <summary>
+				/// Block of the tree when the arena given to Build was too small.
+				/// </summary>
+				Arena fallback;
+
+				static uint32_t HashName(const char* name, int length) {
+					uint32_t hash = TOMLHash::Seed;
+					for (int i = 0; i < length; i++) {
+						hash ^= (unsigned char)(name[i] == '/' ? '.' : name[i]);
+						hash *= TOMLHash::Prime;
+					}
+					return hash;
+				}
+				/// <summary>
+				/// Compares a stored dotted name with a query that may use '/' between its parts.
+				/// </summary>
+				static bool SameName(const char* stored, const char* query, int length) {
+					for (int i = 0; i < length; i++) {
+						if (stored[i] != query[i] && !(stored[i] == '.' && query[i] == '/')) {
+							return false;
+						}
+					}
+					return true;
+				}
+				const char* NameOf(const Node& node) const {
+					return node.source == -1 ? "" : paths[node.source].GetContents();
+				}
+				/// <summary>
+				/// Node of the specified prefix of the name of path source, created under parent if missing.
+				/// </summary>
+				int Intern(int parent, int source, int length, int segment) {
+					const char* name = paths[source].GetContents();
+					uint32_t hash = HashName(name, length);
+					uint32_t cursor;
+					for (int i = nodeIndex.First(hash, cursor); i != -1; i = nodeIndex.Next(hash, cursor)) {
+						if (nodes[i].nameLength == length && SameName(NameOf(nodes[i]), name, length)) {
+							return i;
+						}
+					}
+					Node& node = nodes[nodeCount];
+					node.parent = parent;
+					node.firstChild = -1;
+					node.nextSibling = -1;
+					node.lastChild = -1;
+					node.path = -1;
+					node.source = source;
+					node.nameLength = length;
+					node.segment = segment;
+					node.first = node.count = node.end = 0;
+					Node& owner = nodes[parent];
+					if (owner.lastChild == -1) {
+						owner.firstChild = nodeCount;
+					}
+					else {
+						nodes[owner.lastChild].nextSibling = nodeCount;
+					}
+					owner.lastChild = nodeCount;
+					nodeIndex.Insert(hash, nodeCount);
+					return nodeCount++;
+				}
+				/// <summary>
+				/// Count of the parts of a dotted name, dots within quotes do not split it.
+				/// </summary>
+				static int CountParts(const char* name, int length) {
+					int parts = 1;
+					char quote = 0;
+					for (int i = 0; i < length; i++) {
+						char c = name[i];
+						if (quote) {
+							quote = c == quote ? 0 : quote;
+						}
+						else if (c == '"' || c == '\'') {
+							quote = c;
+						}
+						else if (c == '.') {
+							parts++;
+						}
+					}
+					return parts;
+				}
+			public:
+				/// <summary>
+				/// Nodes the specified path adds to the tree at most, one per part of its dotted name.
+				/// </summary>
+				static int NodesOf(const PathName& path) {
+					return path.IsRoot() ? 0 : CountParts(path.GetContents(), path.GetLength());
+				}
+				/// <summary>
+				/// Bytes Build carves from its arena.
+				/// </summary>
+				/// <param name="nodes">Node count, 1 plus NodesOf every path</param>
+				static size_t SizeOf(int nodes, int paths, int entries) {
+					return Arena::SizeOf<Node>(nodes) + Arena::SizeOf<HashIndex::Slot>(HashIndex::CapacityFor(nodes)) +
+						Arena::SizeOf<int32_t>(paths) + Arena::SizeOf<int32_t>(entries);
+				}
+				/// <summary>
+				/// [Generation only] Builds the tree of the specified paths and the depth first order of the entries.
+				/// The paths must outlive the tree, their names are read on lookups. The tree is carved from the
+				/// arena when it has SizeOf bytes left, from a block of its own otherwise.
+				/// </summary>
+				/// <param name="tables">Table ID of each entry</param>
+				void Build(Arena& arena, const PathName* pathNames, int pathCount, const uint32_t* tables, int entries) {
+					Destroy();
+					int capacity = 1;
+					for (int i = 0; i < pathCount; i++) {
+						capacity += NodesOf(pathNames[i]);
+					}
+					int slots = HashIndex::CapacityFor(capacity);
+					size_t size = SizeOf(capacity, pathCount, entries);
+					Arena* storage = &arena;
+					if (arena.getCapacity() - arena.getUsed() < size) {
+						fallback.Initialize(size);
+						storage = &fallback;
+					}
+					paths = pathNames;
+					nodes = (Node*)storage->Allocate(sizeof(Node) * (size_t)capacity);
+					nodeIndex.Initialize(storage->AllocateArray<HashIndex::Slot>(slots), slots);
+					pathNodes = (int32_t*)storage->Allocate(sizeof(int32_t) * (size_t)pathCount);
+					order = (int32_t*)storage->Allocate(sizeof(int32_t) * (size_t)entries);
+					Node& root = nodes[RootNode];
+					root.parent = root.firstChild = root.nextSibling = root.lastChild = -1;
+					root.path = root.source = -1;
+					root.nameLength = root.segment = 0;
+					root.first = root.count = root.end = 0;
+					nodeCount = 1;
+					for (int i = 0; i < pathCount; i++) {
+						if (pathNames[i].IsRoot()) {
+							root.path = i;
+							pathNodes[i] = RootNode;
+							continue;
+						}
+						const char* name = pathNames[i].GetContents();
+						int length = pathNames[i].GetLength();
+						int node = RootNode;
+						int segment = 0;
+						char quote = 0;
+						for (int j = 0; j <= length; j++) {
+							char c = j < length ? name[j] : '.';
+							if (quote) {
+								quote = c == quote ? 0 : quote;
+								continue;
+							}
+							if (c == '"' || c == '\'') {
+								quote = c;
+							}
+							else if (c == '.') {
+								node = Intern(node, i, j, segment);
+								segment = j + 1;
+							}
+						}
+						// Names equal up to '.' and '/', such as [a.b] and [a/b], share the node of the first one.
+						if (nodes[node].path == -1) {
+							nodes[node].path = i;
+						}
+						pathNodes[i] = node;
+					}
+					// Entries counted per table, the tables laid out depth first, then the entries
+					// placed in document order with count as the cursor of each table.
+					for (int i = 0; i < entries; i++) {
+						nodes[pathNodes[tables[i]]].count++;
+					}
+					int position = 0;
+					int node = RootNode;
+					while (node != -1) {
+						Node& current = nodes[node];
+						current.first = position;
+						position += current.count;
+						current.count = 0;
+						if (current.firstChild != -1) {
+							node = current.firstChild;
+							continue;
+						}
+						// Close the finished subtrees up to the next sibling.
+						while (node != -1) {
+							nodes[node].end = position;
+							if (nodes[node].nextSibling != -1) {
+								node = nodes[node].nextSibling;
+								break;
+							}
+							node = nodes[node].parent;
+						}
+					}
+					for (int i = 0; i < entries; i++) {
+						Node& current = nodes[pathNodes[tables[i]]];
+						order[current.first + current.count++] = i;
+					}
+				}
+				/// <summary>
+				/// Node of the specified dotted name, the empty name is the root node.
+				/// </summary>
+				/// <returns>Node index or -1</returns>
+				int Find(const char* name, int length) const {
+					if (!nodes) {
+						return -1;
+					}
+					if (length == 0) {
+						return RootNode;
+					}
+					uint32_t hash = HashName(name, length);
+					uint32_t cursor;
+					for (int i = nodeIndex.First(hash, cursor); i != -1; i = nodeIndex.Next(hash, cursor)) {
+						if (nodes[i].nameLength == length && SameName(NameOf(nodes[i]), name, length)) {
+							return i;
+						}
+					}
+					return -1;
+				}
+				const Node& getNode(int node) const {
+					return nodes[node];
+				}
+				/// <summary>
+				/// Node holding the entries of the specified path, along with those of the paths sharing it.
+				/// </summary>
+				/// <param name="path">Table ID in Root::Paths</param>
+				/// <returns>Node index, -1 before Build</returns>
+				int NodeOf(int path) const {
+					return pathNodes ? pathNodes[path] : -1;
+				}
+				int getLength() const {
+					return nodeCount;
+				}
+				/// <summary>
+				/// Full dotted name of a node, empty for the root node.
+				/// </summary>
+				TOMLToken getName(int node) const {
+					TOMLToken token = { const_cast<char*>(NameOf(nodes[node])), nodes[node].nameLength };
+					return token;
+				}
+				/// <summary>
+				/// Last part of the name of a node.
+				/// </summary>
+				TOMLToken getSegment(int node) const {
+					TOMLToken token = { const_cast<char*>(NameOf(nodes[node])) + nodes[node].segment, nodes[node].nameLength - nodes[node].segment };
+					return token;
+				}
+				/// <summary>
+				/// Entries of the table of a node alone, in document order.
+				/// </summary>
+				EntryRange Entries(int node) const {
+					EntryRange range = { order + nodes[node].first, order + nodes[node].first + nodes[node].count };
+					return range;
+				}
+				/// <summary>
+				/// Entries of a node and of every table below it.
+				/// </summary>
+				EntryRange Subtree(int node) const {
+					EntryRange range = { order + nodes[node].first, order + nodes[node].end };
+					return range;
+				}
+				/// <summary>
+				/// Bytes held by the tree outside the arena given to Build.
+				/// </summary>
+				size_t SizeOf() const {
+					return fallback.getCapacity();
+				}
+				/// <summary>
+				/// Forgets the tree. Its storage belongs to the arena it was built in, or to its own block.
+				/// </summary>
+				void Destroy() {
+					fallback.Destroy(false);
+					nodeIndex.Destroy();
+					nodes = nullptr;
+					order = nullptr;
+					pathNodes = nullptr;
+					paths = nullptr;
+					nodeCount = 0;
+				}
+				~TableTree() {
+					Destroy();
+				}
+			};
+			/// <summary>
+			/// Entries of a table in a document grouped by table, [offset, offset + count) of the columns.
+			/// </summary>
+			struct TableRange {
+				uint32_t offset;
+				uint32_t count;
+			};
+			/// <summary>
+			/// Entry indexes of a table, usable with range-based for. Grouped documents yield a run of
+			/// consecutive indexes, others walk a list of indexes such as a TableTree::EntryRange.
+			/// </summary>
+			struct EntrySequence {
+				struct Iterator {
+					const int32_t* list;
+					int position;
+					int operator*() const {
+						return list ? list[position] : position;
+					}
+					Iterator& operator++() {
+						position++;
+						return *this;
+					}
+					bool operator!=(const Iterator& other) const {
+						return position != other.position;
+					}
+				};
+				/// <summary>
+				/// Nullable, the indexes are first to last themselves when null.
+				/// </summary>
+				const int32_t* list;
+				int first;
+				int last;
+				Iterator begin() const {
+					Iterator iterator = { list, first };
+					return iterator;
+				}
+				Iterator end() const {
+					Iterator iterator = { list, last };
+					return iterator;
+				}
+				int getLength() const {
+					return last - first;
+				}
+				bool isContiguous() const {
+					return list == nullptr;
+				}
+			};
+			/// <summary>
+			/// Structure-of-arrays description of the entries of a document. Offsets are relative to
+			/// Root::Data, so a whole column scan stays within a few cache lines per hundred entries.
+			/// </summary>
+			struct EntryColumns {
+				uint32_t* KeyOffsets = nullptr;
+				uint32_t* KeyLengths = nullptr;
+				uint32_t* ValueOffsets = nullptr;
+				uint32_t* ValueLengths = nullptr;
+				/// <summary>
+				/// Kind of each value.
+				/// </summary>
+				uint8_t* Kinds = nullptr;
+				/// <summary>
+				/// Index of the path of each entry in Root::Paths.
+				/// </summary>
+				uint32_t* Tables = nullptr;
+				/// <summary>
+				/// Nullable, values decoded at parse time.
+				/// </summary>
+				TOMLScalar* Scalars = nullptr;
+				/// <summary>
+				/// Bytes taken in an arena by the columns of the specified entry count.
+				/// </summary>
+				static size_t SizeOf(int entries, bool scalars) {
+					return Arena::SizeOf<uint32_t>(entries) * 5 +
+						Arena::SizeOf<uint8_t>(entries) +
+						(scalars ? Arena::SizeOf<TOMLScalar>(entries) : 0);
+				}
+				/// <summary>
+				/// [Factory] Carves the columns out of the specified arena.
+				/// </summary>
+				void Initialize(Arena& arena, int entries, bool scalars) {
+					KeyOffsets = (uint32_t*)arena.Allocate(sizeof(uint32_t) * entries);
+					KeyLengths = (uint32_t*)arena.Allocate(sizeof(uint32_t) * entries);
+					ValueOffsets = (uint32_t*)arena.Allocate(sizeof(uint32_t) * entries);
+					ValueLengths = (uint32_t*)arena.Allocate(sizeof(uint32_t) * entries);
+					Kinds = (uint8_t*)arena.Allocate(sizeof(uint8_t) * entries);
+					Tables = (uint32_t*)arena.Allocate(sizeof(uint32_t) * entries);
+					Scalars = scalars ? (TOMLScalar*)arena.Allocate(sizeof(TOMLScalar) * entries) : nullptr;
+				}
+			};
+			/// <summary>
+			/// Represents the main root contents and container of a TOML document.
+			/// </summary>
+			class Root {
+				int idxPaths = 0;
+				int idxEntries = 0;
+				int idxComments = 0;
+			public:
+				/// <summary>
+				/// Factory Initialize
+				/// </summary>
+				Root(no_init) {
+				}
+				Root() {
+					idxPaths = 0;
+					idxEntries = 0;
+					idxComments = 0;
+				}
+				
+				PathName* Paths = nullptr;
+				/// <summary>
+				/// [Compatibility view] Entry objects are built from Columns on demand, use EntryAt.
+				/// </summary>
+				Entry* Entries = nullptr;
+				CommentEntry* Commentaries = nullptr;
+				/// <summary>
+				/// The entries of the document, one array per field.
+				/// </summary>
+				EntryColumns Columns;
+				/// <summary>
+				/// The document original data.
+				/// </summary>
+				char* Data = nullptr;
+				/// <summary>
+				/// Length of Data, without a terminator.
+				/// </summary>
+				size_t DataLength = 0;
+				/// <summary>
+				/// Size of the Data buffer when the document owns it, after its first Parser::Reparse.
+				/// Zero while Data is borrowed from the caller or mapped.
+				/// </summary>
+				size_t OwnedCapacity = 0;
+				/// <summary>
+				/// The columns, comments and indexes are borrowed from a read-only snapshot image held by Mapping.
+				/// </summary>
+				bool ReadOnly = false;
+				/// <summary>
+				/// Backing file of Data when the document was loaded with TOML::LoadFile.
+				/// </summary>
+				MappedFile Mapping;
+				/// <summary>
+				/// Single block holding Paths, Commentaries, Columns and the index slots.
+				/// </summary>
+				Arena Storage;
+				/// <summary>
+				/// Paths by name.
+				/// </summary>
+				HashIndex TableIndex;
+				/// <summary>
+				/// Entries by (table, key).
+				/// </summary>
+				HashIndex EntryIndex;
+				/// <summary>
+				/// Entries by key alone, for lookups that do not name a table.
+				/// </summary>
+				HashIndex KeyIndex;
+				/// <summary>
+				/// Tables by dotted name with their entries in depth first order, built along with the indexes.
+				/// </summary>
+				TableTree Tree;
+				/// <summary>
+				/// Nullable, range of the entries of each path when they are grouped by table, see
+				/// ParseOptions::groupTables. Entry indexes then follow the table IDs rather than the text.
+				/// </summary>
+				TableRange* Ranges = nullptr;
+				/// <summary>
+				/// Nullable, entry indexes in text order, kept when grouping moved entries out of it.
+				/// </summary>
+				int32_t* TextOrder = nullptr;
+				/// <summary>
+				/// Get the count of the collected entries.
+				/// </summary>
+				/// <returns>integer</returns>
+				int getLength() const{
+					return idxEntries;
+				}
+				/// <summary>
+				/// Get the count of the collected paths.
+				/// </summary>
+				/// <returns>integer</returns>
+				int pathCount()const {
+					return idxPaths;
+				}
+				/// <summary>
+				/// Get the count of the collected comments.
+				/// </summary>
+				/// <returns>integer</returns>
+				int commentCount() const {
+					return idxComments;
+				}
+				/// <summary>
+				/// Key token of the specified entry.
+				/// </summary>
+				TOMLToken getKey(int index) const {
+					TOMLToken token = { Data + Columns.KeyOffsets[index], (int)Columns.KeyLengths[index] };
+					return token;
+				}
+				/// <summary>
+				/// Trimmed value token of the specified entry.
+				/// </summary>
+				TOMLToken getValue(int index) const {
+					TOMLToken token = { Data + Columns.ValueOffsets[index], (int)Columns.ValueLengths[index] };
+					return token;
+				}
+				/// <summary>
+				/// The entries are stored contiguously per table, with the range of each path in Ranges.
+				/// </summary>
+				bool isGrouped() const {
+					return Ranges != nullptr;
+				}
+				/// <summary>
+				/// Index of the entry at the specified position in the text.
+				/// </summary>
+				int TextIndex(int position) const {
+					return TextOrder ? TextOrder[position] : position;
+				}
+				/// <summary>
+				/// Entries of the specified path in text order. A single range read in grouped documents,
+				/// the TableTree node of the path in the others, which also holds the entries of the paths
+				/// whose names only differ by '.' and '/'.
+				/// </summary>
+				/// <param name="table">Table ID in Paths</param>
+				EntrySequence getTableEntries(int table) const {
+					EntrySequence sequence = { nullptr, 0, 0 };
+					if (table < 0 || table >= idxPaths) {
+						return sequence;
+					}
+					if (Ranges) {
+						sequence.first = (int)Ranges[table].offset;
+						sequence.last = (int)(Ranges[table].offset + Ranges[table].count);
+						return sequence;
+					}
+					int node = Tree.NodeOf(table);
+					if (node != -1) {
+						TableTree::EntryRange range = Tree.Entries(node);
+						sequence.list = range.first;
+						sequence.last = range.getLength();
+					}
+					return sequence;
+				}
+				/// <summary>
+				/// Kind of the value of the specified entry, classified on its first request in lazy documents.
+				/// </summary>
+				Kind getKind(int index) const {
+					if (Columns.Kinds[index] == (uint8_t)Kind::Unresolved) {
+						Resolve(index);
+					}
+					return (Kind)Columns.Kinds[index];
+				}
+				/// <summary>
+				/// Classifies the value of an entry left Unresolved by a lazy parse and decodes it into the
+				/// scalars column, the results are kept in the columns. Not thread safe, like EntryAt.
+				/// Read-only roots are left untouched, Snapshot::Attach only accepts resolved images.
+				/// </summary>
+				void Resolve(int index) const;
+				/// <summary>
+				/// Resolves every entry left Unresolved by a lazy parse.
+				/// </summary>
+				void ResolveAll() const {
+					for (int i = 0; i < idxEntries; i++) {
+						if (Columns.Kinds[i] == (uint8_t)Kind::Unresolved) {
+							Resolve(i);
+						}
+					}
+				}
+				/// <summary>
+				/// Path of the specified entry.
+				/// </summary>
+				PathName* getPath(int index) const {
+					return &Paths[Columns.Tables[index]];
+				}
+				/// <summary>
+				/// Entry view of the specified entry, built from the columns on its first request.
+				/// The views are allocated on the first call, which is not thread safe.
+				/// </summary>
+				/// <param name="index">Entry index</param>
+				/// <returns>Pointer valid until Destroy</returns>
+				Entry* EntryAt(int index) {
+					if (!Entries) {
+						Entries = new Entry[idxEntries];
+						for (int i = 0; i < idxEntries; i++) {
+							Entries[i].path = nullptr;
+						}
+					}
+					Entry& entry = Entries[index];
+					if (!entry.path) {
+						FillView(index);
+					}
+					return &entry;
+				}
+				/// <summary>
+				/// Rebuilds the entry views that were already requested, after the columns or Data changed.
+				/// </summary>
+				void RefreshViews() {
+					if (!Entries) {
+						return;
+					}
+					for (int i = 0; i < idxEntries; i++) {
+						if (Entries[i].path) {
+							FillView(i);
+						}
+					}
+				}
+				/// <summary>
+				/// Memory held by the document: the root itself, its storage block, the entry views that were
+				/// requested, the text buffer it owns and its mapped file or snapshot image.
+				/// </summary>
+				size_t SizeOf() const {
+					return sizeof(Root) +
+						Storage.getCapacity() +
+						(Entries ? sizeof(Entry) * (size_t)idxEntries : 0) +
+						Tree.SizeOf() +
+						OwnedCapacity +
+						Mapping.getLength();
+				}
+				/// <summary>
+				/// Builds every entry view up front, after which EntryAt only reads the document.
+				/// </summary>
+				void FillViews() {
+					for (int i = 0; i < idxEntries; i++) {
+						EntryAt(i);
+					}
+				}
+				/// <summary>
+				/// Rebuilds the view of the specified entry if it was already requested.
+				/// </summary>
+				void RefreshView(int index) {
+					if (Entries && Entries[index].path) {
+						FillView(index);
+					}
+				}
+			private:
+				void FillView(int index) {
+					Entry& entry = Entries[index];
+					entry.value.kind = getKind(index);
+					entry.value.token = getValue(index);
+					entry.key = getKey(index);
+					entry.scalar = Columns.Scalars ? Columns.Scalars[index] : TOMLScalar::None();
+					entry.path = getPath(index);
+				}
+			public:
+				/// <summary>
+				/// [Generation only] Register an entry from its tokens.
+				/// </summary>
+				/// <param name="path">Index of the entry path in Paths</param>
+				/// <param name="kind">Kind of the value</param>
+				/// <param name="key">Key token within Data</param>
+				/// <param name="value">Trimmed value token within Data</param>
+				/// <param name="scalar">Decoded value, stored when the columns were initialized with scalars</param>
+				void AddEntry(int path, Kind kind, TOMLToken key, TOMLToken value, TOMLScalar scalar) {
+					AddEntryAt(idxEntries, path, kind, key, value, scalar);
+				}
+				/// <summary>
+				/// [Generation only] Register an entry at the specified index, for documents whose entries
+				/// are not laid out in text order. Every index below the final count must be registered once.
+				/// </summary>
+				void AddEntryAt(int index, int path, Kind kind, TOMLToken key, TOMLToken value, TOMLScalar scalar) {
+					Columns.KeyOffsets[index] = (uint32_t)(key.contents - Data);
+					Columns.KeyLengths[index] = (uint32_t)key.length;
+					Columns.ValueOffsets[index] = (uint32_t)(value.contents - Data);
+					Columns.ValueLengths[index] = (uint32_t)value.length;
+					Columns.Kinds[index] = (uint8_t)kind;
+					Columns.Tables[index] = (uint32_t)path;
+					if (Columns.Scalars) {
+						Columns.Scalars[index] = scalar;
+					}
+					idxEntries++;
+				}
+				/// <summary>
+				/// Push an entry.
+				/// </summary>
+				/// <param name="entryModelInstance"></param>
+				void AddEntry(Entry entryModelInstance) {
+					int path = entryModelInstance.path ? (int)(entryModelInstance.path - Paths) : 0;
+					AddEntry(path, entryModelInstance.value.kind, entryModelInstance.key, entryModelInstance.value.token, entryModelInstance.scalar);
+				}
+				/// <summary>
+				/// [Generation only] Register an specified entry
+				/// </summary>
+				/// <param name="entryModelInstance"></param>
+				void AddEntry(PathName* path, Kind kind, TOMLToken token) {
+					Entry entry(path, kind, token);
+					AddEntry(entry);
+				}
+				/// <summary>
+				/// [Generation only] Register an specified entry along with its decoded value
+				/// </summary>
+				void AddEntry(PathName* path, Kind kind, TOMLToken token, TOMLScalar scalar) {
+					Entry entry(path, kind, token, scalar);
+					AddEntry(entry);
+				}
+				/// <summary>
+				///  [Generation only] Register an specified entry (2)
+				/// </summary>
+				/// <param name="path"></param>
+				/// <param name="kind"></param>
+				/// <param name="token"></param>
+				void AddEntryAndPath(PathName& path, Kind kind, TOMLToken token) {
+					AddEntry(&Paths[InternPath(path)], kind, token);
+				}
+				/// <summary>
+				/// [Generation only] Append an path already known to be unique.
+				/// </summary>
+				/// <param name="path"></param>
+				void PushPath(const PathName& path) {
+					Paths[idxPaths++] = path;
+				}
+				/// <summary>
+				/// [Generation Only] Register an path if isnt already
+				/// </summary>
+				/// <param name="path"></param>
+				void AddPath(PathName& path) {
+					InternPath(path);
+				}
+				/// <summary>
+				/// [Generation only] Index of the path with the same name in Paths, appending it if there is none.
+				/// Probes the table index, which BuildIndex rebuilds afterwards.
+				/// </summary>
+				int InternPath(const PathName& path) {
+					uint32_t hash = TOMLHash::Of(path.GetContents(), path.GetLength());
+					uint32_t cursor;
+					for (int i = TableIndex.First(hash, cursor); i != -1; i = TableIndex.Next(hash, cursor)) {
+						if (path.IsRoot() ? Paths[i].IsRoot() : (!Paths[i].IsRoot() && Paths[i].Equals(path.GetContents(), path.GetLength()))) {
+							return i;
+						}
+					}
+					TableIndex.Insert(hash, idxPaths);
+					Paths[idxPaths] = path;
+					return idxPaths++;
+				}
+				/// <summary>
+				/// [Generation only] Register an comment
+				/// </summary>
+				/// <param name="tokenStart"></param>
+				/// <param name="tokenLength"></param>
+				void AddComment(int tokenStart, int tokenLength) {
+					Commentaries[idxComments].index = tokenStart;
+					Commentaries[idxComments].length= tokenLength;
+					idxComments++;
+				}
+				/// <summary>
+				/// [Generation only] Set the originary data.
+				/// </summary>
+				/// <param name="data">Char array</param>
+				void SetData(char* data) {
+					if (OwnedCapacity && data != Data) {
+						delete[] Data;
+						OwnedCapacity = 0;
+					}
+					this->Data = data;
+				}
+				/// <summary>
+				/// [Generation only] Set the originary data along with its length.
+				/// </summary>
+				void SetData(char* data, size_t length) {
+					SetData(data);
+					DataLength = length;
+				}
+				/// <summary>
+				/// Moves Data into an owned buffer of the specified capacity, keeping the paths pointing into it.
+				/// </summary>
+				/// <param name="capacity">Buffer size, above DataLength</param>
+				void OwnData(size_t capacity) {
+					char* owned = new char[capacity];
+					if (DataLength) {
+						Marshal::Copy(Data, owned, DataLength);
+					}
+					owned[DataLength] = 0;
+					for (int i = 0; i < idxPaths; i++) {
+						if (!Paths[i].IsRoot()) {
+							Paths[i] = PathName(owned + (Paths[i].GetContents() - Data), Paths[i].GetLength());
+						}
+					}
+					if (OwnedCapacity) {
+						delete[] Data;
+					}
+					Mapping.Close();
+					Data = owned;
+					OwnedCapacity = capacity;
+				}
+				
+				/// <summary>
+				/// [Generation only] Builds the lookup indexes once every path and entry is registered.
+				/// Duplicated keys resolve to the last entry of the text and duplicated paths to the first one.
+				/// </summary>
+				void BuildIndex() {
+					TableIndex.Clear();
+					EntryIndex.Clear();
+					KeyIndex.Clear();
+					for (int i = 0; i < idxPaths; i++) {
+						if (FindPathIndex(Paths[i].GetContents(), Paths[i].GetLength()) == -1) {
+							TableIndex.Insert(TOMLHash::Of(Paths[i].GetContents(), Paths[i].GetLength()), i);
+						}
+					}
+					for (int i = 0; i < idxEntries; i++) {
+						PathName* path = getPath(i);
+						TOMLToken key = getKey(i);
+
+						uint32_t hash = TOMLHash::Of(path->GetContents(), path->GetLength(), key.contents, key.length);
+						int previous = FindEntryIndex(hash, (int)Columns.Tables[i], key.contents, key.length);
+						if (previous == -1) {
+							EntryIndex.Insert(hash, i);
+						}
+						else {
+							EntryIndex.Replace(hash, previous, i);
+						}
+						hash = TOMLHash::Of(key.contents, key.length);
+						previous = FindKeyIndex(hash, key.contents, key.length);
+						if (previous == -1) {
+							KeyIndex.Insert(hash, i);
+						}
+						else if (Columns.KeyOffsets[i] > Columns.KeyOffsets[previous]) {
+							KeyIndex.Replace(hash, previous, i);
+						}
+					}
+					BuildTree();
+				}
+				/// <summary>
+				/// [Generation only] Builds Tree from the paths and the table of each entry.
+				/// </summary>
+				void BuildTree() {
+					Tree.Build(Storage, Paths, idxPaths, Columns.Tables, idxEntries);
+				}
+				/// <summary>
+				/// Finds an entry by a path whose parts are separated by '/', such as "a/b/c/key" for the key
+				/// of the table [a.b.c]. Dotted keys resolve as well: "a/b/key" also finds "b.key = 1" under [a].
+				/// Each split point from the right costs one probe of the tree and one of the entry index.
+				/// </summary>
+				/// <returns>Entry index or -1</returns>
+				int FindEntryByPath(const char* path, int length) const {
+					for (int separator = length - 1; separator >= 0; separator--) {
+						if (path[separator] != '/') {
+							continue;
+						}
+						int node = Tree.Find(path, separator);
+						int table = node != -1 ? Tree.getNode(node).path : -1;
+						if (table != -1) {
+							const char* key = path + separator + 1;
+							int keyLength = length - separator - 1;
+							int index = ProbeEntry(EntryHash(TableHash(table), key, keyLength), table, key, keyLength);
+							if (index != -1) {
+								return index;
+							}
+						}
+					}
+					return -1;
+				}
+				/// <summary>
+				/// Lookups handled per step by FindEntryIndexes: their hashes are all computed and their index
+				/// slots prefetched before the first probe.
+				/// </summary>
+				static const int LookupBlock = 16;
+				/// <summary>
+				/// Finds a batch of entries, as FindEntryByPath for paths with a '/' and FindKeyIndex otherwise.
+				/// Paths are split once, a table shared with the previous path is resolved once, and the probes
+				/// run after the index slots of the whole block were requested from memory.
+				/// </summary>
+				/// <param name="paths">Null terminated paths, entries may be null</param>
+				/// <param name="count">Path count</param>
+				/// <param name="output">Receives the entry index of each path, or -1</param>
+				/// <returns>Count of the paths found</returns>
+				int FindEntryIndexes(const char* const* paths, int count, int* output) const {
+					uint32_t hashes[LookupBlock];
+					int tables[LookupBlock];
+					int splits[LookupBlock];
+					int lengths[LookupBlock];
+					const char* previous = nullptr;
+					int previousLength = -1;
+					int previousTable = -1;
+					uint32_t previousHash = 0;
+					int found = 0;
+					for (int block = 0; block < count; block += LookupBlock) {
+						int size = count - block < LookupBlock ? count - block : LookupBlock;
+						for (int i = 0; i < size; i++) {
+							const char* path = paths[block + i];
+							int length = path ? (int)sys::strlen(path) : 0;
+							int separator = length - 1;
+							while (separator >= 0 && path[separator] != '/') {
+								separator--;
+							}
+							lengths[i] = length;
+							splits[i] = separator;
+							tables[i] = -1;
+							if (!path || length == 0) {
+								continue;
+							}
+							if (separator == -1) {
+								hashes[i] = TOMLHash::Of(path, length);
+								KeyIndex.Prefetch(hashes[i]);
+								continue;
+							}
+							if (separator != previousLength || strncmp(path, previous, separator) != 0) {
+								int node = Tree.Find(path, separator);
+								previous = path;
+								previousLength = separator;
+								previousTable = node != -1 ? Tree.getNode(node).path : -1;
+								previousHash = previousTable != -1 ? TableHash(previousTable) : 0;
+							}
+							tables[i] = previousTable;
+							if (previousTable != -1) {
+								hashes[i] = EntryHash(previousHash, path + separator + 1, length - separator - 1);
+								EntryIndex.Prefetch(hashes[i]);
+							}
+						}
+						for (int i = 0; i < size; i++) {
+							const char* path = paths[block + i];
+							int index = -1;
+							if (path && lengths[i]) {
+								if (splits[i] == -1) {
+									index = FindKeyIndex(hashes[i], path, lengths[i]);
+								}
+								else {
+									const char* key = path + splits[i] + 1;
+									int keyLength = lengths[i] - splits[i] - 1;
+									index = tables[i] != -1 ? ProbeEntry(hashes[i], tables[i], key, keyLength) : -1;
+									if (index == -1) {
+										// Dotted keys and tables missing at this split are found by the full walk.
+										index = FindEntryByPath(path, lengths[i]);
+									}
+								}
+							}
+							output[block + i] = index;
+							found += index != -1;
+						}
+					}
+					return found;
+				}
+				/// <summary>
+				/// Values of a batch of entries, such as those of FindEntryIndexes. Values decoded at parse time
+				/// are copied, the others are decoded, missing entries and strings give TOMLScalar::None.
+				/// </summary>
+				void ResolveScalars(const int* indexes, int count, TOMLScalar* output) const {
+					for (int i = 0; i < count; i++) {
+						int index = indexes[i];
+						output[i] = TOMLScalar::None();
+						if (index == -1) {
+							continue;
+						}
+						Kind kind = getKind(index);
+						if (Columns.Scalars && Columns.Scalars[index].decoded) {
+							output[i] = Columns.Scalars[index];
+						}
+						else {
+							TOMLToken value = getValue(index);
+							ScalarDecoder::Decode(kind, value.contents, value.length, output[i]);
+						}
+					}
+				}
+			private:
+				/// <summary>
+				/// Hash of a table name followed by the separator, the start of the hash of its entries.
+				/// </summary>
+				uint32_t TableHash(int table) const {
+					return TOMLHash::Of(Paths[table].GetContents(), Paths[table].GetLength(), nullptr, 0);
+				}
+				/// <summary>
+				/// Appends a key to a TableHash. Later parts of a path name a dotted key, stored with '.'.
+				/// </summary>
+				static uint32_t EntryHash(uint32_t hash, const char* key, int keyLength) {
+					for (int i = 0; i < keyLength; i++) {
+						hash ^= (unsigned char)(key[i] == '/' ? '.' : key[i]);
+						hash *= TOMLHash::Prime;
+					}
+					return hash;
+				}
+				/// <summary>
+				/// Probes the (table, key) index for a key of a known table, '/' in the key matching '.'.
+				/// </summary>
+				int ProbeEntry(uint32_t hash, int table, const char* key, int keyLength) const {
+					uint32_t cursor;
+					for (int i = EntryIndex.First(hash, cursor); i != -1; i = EntryIndex.Next(hash, cursor)) {
+						if (Columns.Tables[i] == (uint32_t)table && Columns.KeyLengths[i] == (uint32_t)keyLength) {
+							const char* stored = Data + Columns.KeyOffsets[i];
+							int k = 0;
+							while (k < keyLength && (stored[k] == key[k] || (stored[k] == '.' && key[k] == '/'))) {
+								k++;
+							}
+							if (k == keyLength) {
+								return i;
+							}
+						}
+					}
+					return -1;
+				}
+			public:
+				/// <summary>
+				/// Finds a path through the table index.
+				/// </summary>
+				/// <param name="name">Path name, nullable for the root path</param>
+				/// <param name="length">Path name length</param>
+				/// <returns>Index into Paths or -1</returns>
+				int FindPathIndex(const char* name, int length) const {
+					return FindPathIndex(TOMLHash::Of(name, length), name, length);
+				}
+				/// <summary>
+				/// Finds a path through the table index with its hash already known.
+				/// </summary>
+				/// <param name="hash">TOMLHash::Of(name, length)</param>
+				/// <returns>Index into Paths or -1</returns>
+				int FindPathIndex(uint32_t hash, const char* name, int length) const {
+					uint32_t cursor;
+					for (int i = TableIndex.First(hash, cursor); i != -1; i = TableIndex.Next(hash, cursor)) {
+						if (Paths[i].Equals(name, length)) {
+							return i;
+						}
+					}
+					return -1;
+				}
+				/// <summary>
+				/// Finds an entry through the (table, key) index.
+				/// </summary>
+				/// <returns>Entry index or -1</returns>
+				int FindEntryIndex(const char* table, int tableLength, const char* key, int keyLength) const {
+					return FindEntryIndex(TOMLHash::Of(table, tableLength, key, keyLength), table, tableLength, key, keyLength);
+				}
+				/// <summary>
+				/// Finds an entry through the (table, key) index with its hash already known.
+				/// </summary>
+				/// <param name="hash">TOMLHash::Of(table, tableLength, key, keyLength)</param>
+				/// <returns>Entry index or -1</returns>
+				int FindEntryIndex(uint32_t hash, const char* table, int tableLength, const char* key, int keyLength) const {
+					int path = FindPathIndex(table, tableLength);
+					return path != -1 ? FindEntryIndex(hash, path, key, keyLength) : -1;
+				}
+				/// <summary>
+				/// Finds an entry of a known table through the (table, key) index. Table names are interned,
+				/// so candidates are matched on their table ID instead of the name.
+				/// </summary>
+				/// <param name="hash">TOMLHash::Of(table, tableLength, key, keyLength)</param>
+				/// <param name="table">Table ID, the index of the table in Paths</param>
+				/// <returns>Entry index or -1</returns>
+				int FindEntryIndex(uint32_t hash, int table, const char* key, int keyLength) const {
+					uint32_t cursor;
+					for (int i = EntryIndex.First(hash, cursor); i != -1; i = EntryIndex.Next(hash, cursor)) {
+						if (Columns.Tables[i] == (uint32_t)table &&
+							Columns.KeyLengths[i] == (uint32_t)keyLength &&
+							strncmp(Data + Columns.KeyOffsets[i], key, keyLength) == 0) {
+							return i;
+						}
+					}
+					return -1;
+				}
+				/// <summary>
+				/// Finds an entry by its key alone, whatever its table. A key used more than once resolves to
+				/// its last occurrence in the text, as indexed by BuildIndex.
+				/// </summary>
+				/// <returns>Entry index or -1</returns>
+				int FindKeyIndex(const char* key, int keyLength) const {
+					return FindKeyIndex(TOMLHash::Of(key, keyLength), key, keyLength);
+				}
+				/// <summary>
+				/// Finds the entry indexed for the specified key, its hash already computed.
+				/// </summary>
+				int FindKeyIndex(uint32_t hash, const char* key, int keyLength) const {
+					uint32_t cursor;
+					for (int i = KeyIndex.First(hash, cursor); i != -1; i = KeyIndex.Next(hash, cursor)) {
+						if (Columns.KeyLengths[i] == (uint32_t)keyLength && strncmp(Data + Columns.KeyOffsets[i], key, keyLength) == 0) {
+							return i;
+						}
+					}
+					return -1;
+				}
+
+				/// <summary>
+				/// Destroy this instance, releasing its storage with a single free.
+				/// </summary>
+				/// <param name="wipe">Clears the storage before releasing it</param>
+				void Destroy(bool wipe = false) {
+					TableIndex.Destroy();
+					EntryIndex.Destroy();
+					KeyIndex.Destroy();
+					Tree.Destroy();
+					Storage.Destroy(wipe);
+					Mapping.Close();
+					if (OwnedCapacity) {
+						if (wipe) {
+							sys::memset(Data, 0, OwnedCapacity);
+						}
+						delete[] Data;
+						Data = nullptr;
+						OwnedCapacity = 0;
+					}
+					delete[] Entries;
+					Paths = nullptr;
+					Entries = nullptr;
+					Commentaries = nullptr;
+					Columns = EntryColumns();
+					Ranges = nullptr;
+					TextOrder = nullptr;
+					ReadOnly = false;
+					idxPaths = 0;
+					idxEntries = 0;
+					idxComments = 0;
+				}
+				/// <summary>
+				/// [Generation only] Carves the storage of the document, and its index slots, out of one block.
+				/// </summary>
+				/// <param name="scalars">Reserves the decoded values column</param>
+				/// <param name="grouped">Reserves Ranges and TextOrder</param>
+				/// <param name="nodes">Tree node count, 1 plus TableTree::NodesOf every path. The tree gets its own
+				/// block when left out</param>
+				void Initialize(int paths, int entries, int comments, bool scalars = false, bool grouped = false, int nodes = 0) {
+					int pathSlots = HashIndex::CapacityFor(paths);
+					int entrySlots = HashIndex::CapacityFor(entries);
+					Storage.Destroy(false);
+					Storage.Initialize(
+						Arena::SizeOf<PathName>(paths) +
+						Arena::SizeOf<CommentEntry>(comments) +
+						EntryColumns::SizeOf(entries, scalars) +
+						Arena::SizeOf<HashIndex::Slot>(pathSlots) +
+						Arena::SizeOf<HashIndex::Slot>(entrySlots) * 2 +
+						(grouped ? Arena::SizeOf<TableRange>(paths) + Arena::SizeOf<int32_t>(entries) : 0) +
+						(nodes ? TableTree::SizeOf(nodes, paths, entries) : 0));
+					Paths = Storage.AllocateArray<PathName>(paths);
+					Commentaries = Storage.AllocateArray<CommentEntry>(comments);
+					Columns.Initialize(Storage, entries, scalars);
+					Ranges = grouped ? Storage.AllocateArray<TableRange>(paths) : nullptr;
+					TextOrder = grouped ? (int32_t*)Storage.Allocate(sizeof(int32_t) * entries) : nullptr;
+					Tree.Destroy();
+					TableIndex.Initialize(Storage.AllocateArray<HashIndex::Slot>(pathSlots), pathSlots);
+					EntryIndex.Initialize(Storage.AllocateArray<HashIndex::Slot>(entrySlots), entrySlots);
+					KeyIndex.Initialize(Storage.AllocateArray<HashIndex::Slot>(entrySlots), entrySlots);
+					delete[] Entries;
+					Entries = nullptr;
+					ReadOnly = false;
+					idxPaths = 0;
+					idxEntries = 0;
+					idxComments = 0;
+				}
+				/// <summary>
+				/// [Generation only] Allocates the paths and the room of the tree alone and sets the counts, the caller
+				/// fills Paths and points Commentaries, Columns and the indexes at storage that outlives the document.
+				/// </summary>
+				/// <param name="nodes">Tree node count, 1 plus TableTree::NodesOf every path</param>
+				void InitializeBorrowed(int paths, int entries, int comments, int nodes) {
+					Tree.Destroy();
+					TableIndex.Destroy();
+					EntryIndex.Destroy();
+					KeyIndex.Destroy();
+					Storage.Destroy(false);
+					Storage.Initialize(Arena::SizeOf<PathName>(paths) + TableTree::SizeOf(nodes, paths, entries));
+					Paths = Storage.AllocateArray<PathName>(paths);
+					Commentaries = nullptr;
+					Columns = EntryColumns();
+					Ranges = nullptr;
+					TextOrder = nullptr;
+					delete[] Entries;
+					Entries = nullptr;
+					ReadOnly = true;
+					idxPaths = paths;
+					idxEntries = entries;
+					idxComments = comments;
+				}
+				/// <summary>
+				/// Let him destroy this instance manually.
+				/// </summary>
+				~Root() {
+					__nop();
+				}
+			};
+			/// <summary>
+			/// Single pass staging area for a document being parsed. Paths, entries and comments are
+			/// appended into chunked storage, then moved into an exactly sized Root by Finalize.
+			/// </summary>
+			class DocumentBuilder {
+			public:
+				/// <summary>
+				/// Entry waiting for its path storage to be allocated, refers to its path by index.
+				/// </summary>
+				struct StagedEntry {
+					int path;
+					Kind kind;
+					TOMLToken key;
+					TOMLToken value;
+					TOMLScalar scalar;
+				};
+			private:
+				ChunkedStorage<PathName> paths;
+				ChunkedStorage<StagedEntry> entries;
+				ChunkedStorage<CommentEntry> comments;
+				/// <summary>
+				/// Interned paths by name hash. A path index is the table ID of its entries.
+				/// </summary>
+				HashIndex pathIndex;
+				/// <summary>
+				/// Index of the current path, -1 while the root path has not been registered yet.
+				/// </summary>
+				int currentPath = -1;
+				bool currentIsRoot = true;
+				bool hasScalars = false;
+				/// <summary>
+				/// Places the staged entries table by table with a counting sort, in text order within a
+				/// table, and fills the ranges and the text order of the root.
+				/// </summary>
+				void PlaceGrouped(Root& root) {
+					int pathCount = paths.getLength();
+					int entryCount = entries.getLength();
+					TableRange* ranges = root.Ranges;
+					for (int i = 0; i < entryCount; i++) {
+						ranges[entries[i].path].count++;
+					}
+					uint32_t offset = 0;
+					for (int i = 0; i < pathCount; i++) {
+						ranges[i].offset = offset;
+						offset += ranges[i].count;
+					}
+					uint32_t* next = new uint32_t[pathCount ? pathCount : 1];
+					for (int i = 0; i < pathCount; i++) {
+						next[i] = ranges[i].offset;
+					}
+					bool moved = false;
+					for (int i = 0; i < entryCount; i++) {
+						const StagedEntry& entry = entries[i];
+						int index = (int)next[entry.path]++;
+						root.AddEntryAt(index, entry.path, entry.kind, entry.key, entry.value, entry.scalar);
+						root.TextOrder[i] = index;
+						moved = moved || index != i;
+					}
+					delete[] next;
+					if (!moved) {
+						// Every table came in a single run, the text order is the index order.
+						root.TextOrder = nullptr;
+					}
+				}
+			public:
+				/// <summary>
+				/// Registers an path header if it isnt already and makes it the current path.
+				/// </summary>
+				/// <param name="name">Path name token, after the opening bracket</param>
+				/// <param name="length">Path name length</param>
+				void AddPath(char* name, int length) {
+					currentIsRoot = false;
+					currentPath = InternPath(PathName(name, length));
+				}
+				/// <summary>
+				/// Index of the path with the same name, registering it if there is none. One hash probe,
+				/// the index grows along with the paths.
+				/// </summary>
+				int InternPath(const PathName& path) {
+					bool root = path.IsRoot();
+					uint32_t hash = TOMLHash::Of(path.GetContents(), path.GetLength());
+					uint32_t cursor;
+					for (int i = pathIndex.First(hash, cursor); i != -1; i = pathIndex.Next(hash, cursor)) {
+						if (root ? paths[i].IsRoot() : (!paths[i].IsRoot() && paths[i].Equals(path.GetContents(), path.GetLength()))) {
+							return i;
+						}
+					}
+					if ((paths.getLength() + 1) * 2 > pathIndex.getCapacity()) {
+						pathIndex.Destroy();
+						pathIndex.Initialize((paths.getLength() + 1) * 2);
+						for (int i = 0; i < paths.getLength(); i++) {
+							pathIndex.Insert(TOMLHash::Of(paths[i].GetContents(), paths[i].GetLength()), i);
+						}
+					}
+					int index = paths.Push(path);
+					pathIndex.Insert(hash, index);
+					return index;
+				}
+				/// <summary>
+				/// Appends a builder that staged the text right after this one. Its paths are merged
+				/// by name, so the result is the same as staging both texts with a single builder.
+				/// </summary>
+				/// <param name="part">Builder of the following text, starting at a path header or empty</param>
+				void Append(const DocumentBuilder& part) {
+					int count = part.paths.getLength();
+					int* remap = count ? new int[count] : nullptr;
+					for (int i = 0; i < count; i++) {
+						remap[i] = InternPath(part.paths[i]);
+					}
+					for (int i = 0; i < part.entries.getLength(); i++) {
+						StagedEntry entry = part.entries[i];
+						entry.path = remap[entry.path];
+						entries.Push(entry);
+					}
+					for (int i = 0; i < part.comments.getLength(); i++) {
+						comments.Push(part.comments[i]);
+					}
+					hasScalars |= part.hasScalars;
+					if (part.currentPath != -1) {
+						currentPath = remap[part.currentPath];
+						currentIsRoot = part.currentIsRoot;
+					}
+					delete[] remap;
+				}
+				/// <summary>
+				/// Registers an entry under the current path, registering the root path on its first use.
+				/// </summary>
+				void AddEntry(Kind kind, TOMLToken key, TOMLToken value, TOMLScalar scalar) {
+					if (currentIsRoot && currentPath == -1) {
+						currentPath = InternPath(PathName());
+					}
+					StagedEntry entry = { currentPath, kind, key, value, scalar };
+					entries.Push(entry);
+					hasScalars |= scalar.decoded;
+				}
+				void AddComment(int tokenStart, int tokenLength) {
+					comments.Push(CommentEntry(tokenStart, tokenLength));
+				}
+				/// <summary>
+				/// Allocates the scalars column even if nothing was decoded while staging.
+				/// </summary>
+				void KeepScalars() {
+					hasScalars = true;
+				}
+				/// <summary>
+				/// Empties the builder for another document, keeping its chunks and path index slots.
+				/// </summary>
+				void Reset() {
+					paths.Clear();
+					entries.Clear();
+					comments.Clear();
+					pathIndex.Clear();
+					currentPath = -1;
+					currentIsRoot = true;
+					hasScalars = false;
+				}
+				/// <summary>
+				/// Moves the staged document into the root, sized with the exact counts.
+				/// The root data must already be set, the entry columns are offsets into it.
+				/// </summary>
+				void Finalize(Root& root, bool grouped = false) {
+					int nodes = 1;
+					for (int i = 0; i < paths.getLength(); i++) {
+						nodes += TableTree::NodesOf(paths[i]);
+					}
+					root.Initialize(paths.getLength(), entries.getLength(), comments.getLength(), hasScalars, grouped, nodes);
+					for (int i = 0; i < paths.getLength(); i++) {
+						root.PushPath(paths[i]);
+					}
+					if (grouped) {
+						PlaceGrouped(root);
+					}
+					else {
+						for (int i = 0; i < entries.getLength(); i++) {
+							const StagedEntry& entry = entries[i];
+							root.AddEntry(entry.path, entry.kind, entry.key, entry.value, entry.scalar);
+						}
+					}
+					for (int i = 0; i < comments.getLength(); i++) {
+						root.AddComment(comments[i].index, comments[i].length);
+					}
+				}
+				~DocumentBuilder() {
+					pathIndex.Destroy();
+				}
+			};
+			/// <summary>
+			/// Binary image of a parsed document. The image holds the paths, comments, entry columns,
+			/// decoded scalars, lookup indexes and the source text, each section 16 bytes aligned, so a
+			/// mapped image is used in place: attaching it only rebuilds the path table.
+			/// Images are native endian, an image written on another byte order fails the magic check.
+			/// </summary>
+			class Snapshot {
+			public:
+				static const uint32_t Magic = 0x534D4F54;
+				static const uint16_t Version = 3;
+				enum HeaderFlags {
+					HasScalars = 1,
+					/// <summary>
+					/// Entries grouped by table, with the Ranges section.
+					/// </summary>
+					Grouped = 2,
+					/// <summary>
+					/// Grouping moved entries out of text order, with the TextOrder section.
+					/// </summary>
+					HasTextOrder = 4,
+				};
+				enum Section {
+					SectionPaths,
+					SectionComments,
+					SectionKeyOffsets,
+					SectionKeyLengths,
+					SectionValueOffsets,
+					SectionValueLengths,
+					SectionKinds,
+					SectionTables,
+					SectionScalars,
+					SectionTableSlots,
+					SectionEntrySlots,
+					SectionKeySlots,
+					SectionRanges,
+					SectionTextOrder,
+					SectionText,
+					SectionCount
+				};
+				struct Header {
+					uint32_t magic;
+					uint16_t version;
+					uint16_t flags;
+					/// <summary>
+					/// TOMLHash::Content of the source text.
+					/// </summary>
+					uint64_t sourceHash;
+					uint64_t sourceLength;
+					uint64_t imageLength;
+					uint32_t paths;
+					uint32_t entries;
+					uint32_t comments;
+					uint32_t tableSlots;
+					uint32_t entrySlots;
+					uint32_t tableCount;
+					uint32_t entryCount;
+					uint32_t keyCount;
+					/// <summary>
+					/// Offsets of the sections from the start of the image.
+					/// </summary>
+					uint64_t sections[SectionCount];
+				};
+				/// <summary>
+				/// Path name as an offset into the text, RootPath for the root path.
+				/// </summary>
+				struct PathRecord {
+					uint32_t offset;
+					uint32_t length;
+				};
+				static const uint32_t RootPath = 0xFFFFFFFFu;
+			private:
+				/// <summary>
+				/// Section sizes of the specified root, in Section order.
+				/// </summary>
+				static void Measure(const Root& root, size_t* sizes) {
+					size_t entries = (size_t)root.getLength();
+					size_t entrySlots = (size_t)root.EntryIndex.getCapacity();
+					sizes[SectionPaths] = sizeof(PathRecord) * (size_t)root.pathCount();
+					sizes[SectionComments] = sizeof(CommentEntry) * (size_t)root.commentCount();
+					sizes[SectionKeyOffsets] = sizeof(uint32_t) * entries;
+					sizes[SectionKeyLengths] = sizeof(uint32_t) * entries;
+					sizes[SectionValueOffsets] = sizeof(uint32_t) * entries;
+					sizes[SectionValueLengths] = sizeof(uint32_t) * entries;
+					sizes[SectionKinds] = sizeof(uint8_t) * entries;
+					sizes[SectionTables] = sizeof(uint32_t) * entries;
+					sizes[SectionScalars] = root.Columns.Scalars ? sizeof(TOMLScalar) * entries : 0;
+					sizes[SectionTableSlots] = sizeof(HashIndex::Slot) * (size_t)root.TableIndex.getCapacity();
+					sizes[SectionEntrySlots] = sizeof(HashIndex::Slot) * entrySlots;
+					sizes[SectionKeySlots] = sizeof(HashIndex::Slot) * entrySlots;
+					sizes[SectionRanges] = root.Ranges ? sizeof(TableRange) * (size_t)root.pathCount() : 0;
+					sizes[SectionTextOrder] = root.TextOrder ? sizeof(int32_t) * entries : 0;
+					sizes[SectionText] = root.DataLength + 1;
+				}
+				/// <summary>
+				/// Checks the slots of an index read from an image: every target below targets, as many
+				/// filled slots as the header counts and at least one empty slot so probes terminate.
+				/// </summary>
+				static bool ValidSlots(const HashIndex::Slot* slots, uint32_t capacity, uint32_t count, uint32_t targets) {
+					uint32_t filled = 0;
+					for (uint32_t i = 0; i < capacity; i++) {
+						if (slots[i].target == -1) {
+							continue;
+						}
+						if (slots[i].target < 0 || (uint32_t)slots[i].target >= targets) {
+							return false;
+						}
+						filled++;
+					}
+					return filled == count && count < capacity;
+				}
+				/// <summary>
+				/// Checks that a token [offset, offset + length) lies within the source text.
+				/// </summary>
+				static bool InText(uint64_t offset, uint64_t length, uint64_t sourceLength) {
+					return offset <= sourceLength && length <= sourceLength - offset;
+				}
+			public:
+				/// <summary>
+				/// Bytes needed by the image of the specified root.
+				/// </summary>
+				static size_t SizeOf(const Root& root) {
+					size_t sizes[SectionCount];
+					Measure(root, sizes);
+					size_t total = Arena::Align(sizeof(Header));
+					for (int i = 0; i < SectionCount; i++) {
+						total += Arena::Align(sizes[i]);
+					}
+					return total;
+				}
+				/// <summary>
+				/// Writes the image of a parsed root. The entries of a lazy document are resolved first,
+				/// images are mapped read-only.
+				/// </summary>
+				/// <param name="root">Parsed document, with its indexes built</param>
+				/// <param name="sourceHash">TOMLHash::Content of the text the root was parsed from</param>
+				/// <param name="buffer">Target buffer, 16 bytes aligned</param>
+				/// <param name="capacity">Target buffer size, see SizeOf</param>
+				/// <returns>Bytes written, 0 if the buffer is too small</returns>
+				static size_t Write(const Root& root, uint64_t sourceHash, char* buffer, size_t capacity) {
+					size_t total = SizeOf(root);
+					if (!buffer || capacity < total) {
+						return 0;
+					}
+					root.ResolveAll();
+					size_t sizes[SectionCount];
+					Measure(root, sizes);
+					sys::memset(buffer, 0, total);
+					Header& header = *(Header*)buffer;
+					header.magic = Magic;
+					header.version = Version;
+					header.flags = (root.Columns.Scalars ? HasScalars : 0) | (root.Ranges ? Grouped : 0) | (root.TextOrder ? HasTextOrder : 0);
+					header.sourceHash = sourceHash;
+					header.sourceLength = root.DataLength;
+					header.imageLength = total;
+					header.paths = (uint32_t)root.pathCount();
+					header.entries = (uint32_t)root.getLength();
+					header.comments = (uint32_t)root.commentCount();
+					header.tableSlots = (uint32_t)root.TableIndex.getCapacity();
+					header.entrySlots = (uint32_t)root.EntryIndex.getCapacity();
+					header.tableCount = (uint32_t)root.TableIndex.getLength();
+					header.entryCount = (uint32_t)root.EntryIndex.getLength();
+					header.keyCount = (uint32_t)root.KeyIndex.getLength();
+					size_t offset = Arena::Align(sizeof(Header));
+					for (int i = 0; i < SectionCount; i++) {
+						header.sections[i] = offset;
+						offset += Arena::Align(sizes[i]);
+					}
+
+					PathRecord* paths = (PathRecord*)(buffer + header.sections[SectionPaths]);
+					for (int i = 0; i < root.pathCount(); i++) {
+						const PathName& path = root.Paths[i];
+						paths[i].offset = path.IsRoot() ? RootPath : (uint32_t)(path.GetContents() - root.Data);
+						paths[i].length = (uint32_t)path.GetLength();
+					}
+					CommentEntry* comments = (CommentEntry*)(buffer + header.sections[SectionComments]);
+					for (int i = 0; i < root.commentCount(); i++) {
+						comments[i].index = root.Commentaries[i].index;
+						comments[i].length = root.Commentaries[i].length;
+					}
+					const EntryColumns& columns = root.Columns;
+					const void* sources[] = {
+						columns.KeyOffsets, columns.KeyLengths, columns.ValueOffsets, columns.ValueLengths, columns.Kinds, columns.Tables
+					};
+					for (int i = SectionKeyOffsets; i <= SectionTables; i++) {
+						if (sizes[i]) {
+							Marshal::Copy(sources[i - SectionKeyOffsets], buffer + header.sections[i], sizes[i]);
+						}
+					}
+					if (columns.Scalars) {
+						TOMLScalar* scalars = (TOMLScalar*)(buffer + header.sections[SectionScalars]);
+						for (int i = 0; i < root.getLength(); i++) {
+							scalars[i].integer = columns.Scalars[i].integer;
+							scalars[i].decoded = columns.Scalars[i].decoded;
+						}
+					}
+					const HashIndex* indexes[] = { &root.TableIndex, &root.EntryIndex, &root.KeyIndex };
+					for (int i = 0; i < 3; i++) {
+						if (sizes[SectionTableSlots + i]) {
+							Marshal::Copy(indexes[i]->getSlots(), buffer + header.sections[SectionTableSlots + i], sizes[SectionTableSlots + i]);
+						}
+					}
+					if (sizes[SectionRanges]) {
+						Marshal::Copy(root.Ranges, buffer + header.sections[SectionRanges], sizes[SectionRanges]);
+					}
+					if (sizes[SectionTextOrder]) {
+						Marshal::Copy(root.TextOrder, buffer + header.sections[SectionTextOrder], sizes[SectionTextOrder]);
+					}
+					if (root.DataLength) {
+						Marshal::Copy(root.Data, buffer + header.sections[SectionText], root.DataLength);
+					}
+					return total;
+				}
+				/// <summary>
+				/// Writes the image of a parsed root into a file. The image is written next to the target
+				/// and renamed over it, so concurrent readers see either the previous image or the new one.
+				/// </summary>
+				/// <returns>True if sucess.</returns>
+				static Boolean Save(const Root& root, uint64_t sourceHash, const char* path) {
+					if (!path) {
+						return false;
+					}
+					size_t total = SizeOf(root);
+					char* image = (char*)new byte[total];
+					bool saved = false;
+					if (Write(root, sourceHash, image, total)) {
+						size_t length = sys::strlen(path);
+						char* temporary = new char[length + 5];
+						Marshal::Copy(path, temporary, length);
+						Marshal::Copy(".tmp", temporary + length, 5);
+						FILE* file = fopen(temporary, "wb");
+						if (file) {
+							saved = fwrite(image, 1, total, file) == total;
+							saved = fclose(file) == 0 && saved;
+							saved = saved && rename(temporary, path) == 0;
+							if (!saved) {
+								remove(temporary);
+							}
+						}
+						delete[] temporary;
+					}
+					delete[] (byte*)image;
+					return saved;
+				}
+				/// <summary>
+				/// Validates an image and points the root at it. The image must stay alive and unchanged
+				/// until the root is destroyed, the root is read-only until then.
+				/// </summary>
+				/// <param name="image">Image, 16 bytes aligned</param>
+				/// <param name="length">Image length</param>
+				/// <param name="sourceHash">TOMLHash::Content of the current source text</param>
+				/// <param name="sourceLength">Length of the current source text</param>
+				/// <param name="requireScalars">Rejects images written without decoded scalars</param>
+				/// <param name="requireGrouped">Rejects images whose entries are not grouped by table</param>
+				/// <returns>False if the image is malformed or stale, the root is untouched then</returns>
+				static Boolean Attach(Root& root, const char* image, size_t length, uint64_t sourceHash, size_t sourceLength, bool requireScalars = false, bool requireGrouped = false) {
+					if (!image || length < sizeof(Header) || ((uintptr_t)image & (Arena::Alignment - 1))) {
+						return false;
+					}
+					const Header& header = *(const Header*)image;
+					if (header.magic != Magic || header.version != Version || header.imageLength != length ||
+						header.sourceHash != sourceHash || header.sourceLength != sourceLength ||
+						(requireScalars && !(header.flags & HasScalars)) || (requireGrouped && !(header.flags & Grouped))) {
+						return false;
+					}
+					if (header.paths > 0x7FFFFFFFu || header.entries > 0x7FFFFFFFu || (header.entries && !header.paths) ||
+						!header.tableSlots || (header.tableSlots & (header.tableSlots - 1)) ||
+						!header.entrySlots || (header.entrySlots & (header.entrySlots - 1)) ||
+						header.tableCount > header.paths || header.entryCount > header.entries || header.keyCount > header.entries ||
+						header.tableSlots <= header.tableCount || header.entrySlots <= header.entryCount || header.entrySlots <= header.keyCount) {
+						return false;
+					}
+					size_t entries = header.entries;
+					size_t sizes[SectionCount] = {
+						sizeof(PathRecord) * header.paths, sizeof(CommentEntry) * header.comments,
+						sizeof(uint32_t) * entries, sizeof(uint32_t) * entries, sizeof(uint32_t) * entries, sizeof(uint32_t) * entries,
+						sizeof(uint8_t) * entries, sizeof(uint32_t) * entries,
+						(header.flags & HasScalars) ? sizeof(TOMLScalar) * entries : 0,
+						sizeof(HashIndex::Slot) * header.tableSlots, sizeof(HashIndex::Slot) * header.entrySlots, sizeof(HashIndex::Slot) * header.entrySlots,
+						(header.flags & Grouped) ? sizeof(TableRange) * header.paths : 0,
+						(header.flags & HasTextOrder) ? sizeof(int32_t) * entries : 0,
+						(size_t)header.sourceLength + 1
+					};
+					for (int i = 0; i < SectionCount; i++) {
+						uint64_t offset = header.sections[i];
+						if ((offset & (Arena::Alignment - 1)) || offset < sizeof(Header) || offset > length || sizes[i] > length - offset) {
+							return false;
+						}
+					}
+					const char* text = image + header.sections[SectionText];
+					const PathRecord* paths = (const PathRecord*)(image + header.sections[SectionPaths]);
+					for (uint32_t i = 0; i < header.paths; i++) {
+						if (paths[i].offset != RootPath && !InText(paths[i].offset, paths[i].length, header.sourceLength)) {
+							return false;
+						}
+					}
+					const CommentEntry* comments = (const CommentEntry*)(image + header.sections[SectionComments]);
+					for (uint32_t i = 0; i < header.comments; i++) {
+						// The writer skips the '#' before the comment text.
+						if (comments[i].index < 0 || comments[i].length < 0 || !InText((uint64_t)comments[i].index + 1, (uint64_t)comments[i].length, header.sourceLength)) {
+							return false;
+						}
+					}
+					const uint32_t* keyOffsets = (const uint32_t*)(image + header.sections[SectionKeyOffsets]);
+					const uint32_t* keyLengths = (const uint32_t*)(image + header.sections[SectionKeyLengths]);
+					const uint32_t* valueOffsets = (const uint32_t*)(image + header.sections[SectionValueOffsets]);
+					const uint32_t* valueLengths = (const uint32_t*)(image + header.sections[SectionValueLengths]);
+					const uint32_t* tables = (const uint32_t*)(image + header.sections[SectionTables]);
+					const uint8_t* kinds = (const uint8_t*)(image + header.sections[SectionKinds]);
+					const TOMLScalar* scalars = (header.flags & HasScalars) ? (const TOMLScalar*)(image + header.sections[SectionScalars]) : nullptr;
+					for (uint32_t i = 0; i < header.entries; i++) {
+						if (!InText(keyOffsets[i], keyLengths[i], header.sourceLength) || !InText(valueOffsets[i], valueLengths[i], header.sourceLength) ||
+							tables[i] >= header.paths) {
+							return false;
+						}
+						// Images are written resolved, Resolve must never write into the read-only columns.
+						if (kinds[i] > (uint8_t)Kind::Unknown || (scalars && *(const uint8_t*)&scalars[i].decoded > 1)) {
+							return false;
+						}
+					}
+					if (!ValidSlots((const HashIndex::Slot*)(image + header.sections[SectionTableSlots]), header.tableSlots, header.tableCount, header.paths) ||
+						!ValidSlots((const HashIndex::Slot*)(image + header.sections[SectionEntrySlots]), header.entrySlots, header.entryCount, header.entries) ||
+						!ValidSlots((const HashIndex::Slot*)(image + header.sections[SectionKeySlots]), header.entrySlots, header.keyCount, header.entries)) {
+						return false;
+					}
+					const TableRange* ranges = (const TableRange*)(image + header.sections[SectionRanges]);
+					for (uint32_t i = 0; (header.flags & Grouped) && i < header.paths; i++) {
+						if (ranges[i].offset > header.entries || ranges[i].count > header.entries - ranges[i].offset) {
+							return false;
+						}
+					}
+					const int32_t* textOrder = (const int32_t*)(image + header.sections[SectionTextOrder]);
+					for (uint32_t i = 0; (header.flags & HasTextOrder) && i < header.entries; i++) {
+						if (textOrder[i] < 0 || (uint32_t)textOrder[i] >= header.entries) {
+							return false;
+						}
+					}
+
+					int nodes = 1;
+					for (uint32_t i = 0; i < header.paths; i++) {
+						nodes += paths[i].offset == RootPath ? 0 : TableTree::NodesOf(PathName(const_cast<char*>(text) + paths[i].offset, (int)paths[i].length));
+					}
+
+					root.Destroy();
+					root.InitializeBorrowed((int)header.paths, (int)header.entries, (int)header.comments, nodes);
+					root.Data = const_cast<char*>(text);
+					root.DataLength = (size_t)header.sourceLength;
+					for (uint32_t i = 0; i < header.paths; i++) {
+						root.Paths[i] = paths[i].offset == RootPath ? PathName() : PathName(root.Data + paths[i].offset, (int)paths[i].length);
+					}
+					root.Commentaries = (CommentEntry*)(image + header.sections[SectionComments]);
+					EntryColumns& columns = root.Columns;
+					columns.KeyOffsets = (uint32_t*)(image + header.sections[SectionKeyOffsets]);
+					columns.KeyLengths = (uint32_t*)(image + header.sections[SectionKeyLengths]);
+					columns.ValueOffsets = (uint32_t*)(image + header.sections[SectionValueOffsets]);
+					columns.ValueLengths = (uint32_t*)(image + header.sections[SectionValueLengths]);
+					columns.Kinds = (uint8_t*)(image + header.sections[SectionKinds]);
+					columns.Tables = (uint32_t*)(image + header.sections[SectionTables]);
+					columns.Scalars = (header.flags & HasScalars) ? (TOMLScalar*)(image + header.sections[SectionScalars]) : nullptr;
+					root.TableIndex.Attach((const HashIndex::Slot*)(image + header.sections[SectionTableSlots]), (int)header.tableSlots, (int)header.tableCount);
+					root.EntryIndex.Attach((const HashIndex::Slot*)(image + header.sections[SectionEntrySlots]), (int)header.entrySlots, (int)header.entryCount);
+					root.KeyIndex.Attach((const HashIndex::Slot*)(image + header.sections[SectionKeySlots]), (int)header.entrySlots, (int)header.keyCount);
+					root.Ranges = (header.flags & Grouped) ? const_cast<TableRange*>(ranges) : nullptr;
+					root.TextOrder = (header.flags & HasTextOrder) ? const_cast<int32_t*>(textOrder) : nullptr;
+					root.BuildTree();
+					return true;
+				}
+			};
+			/// <summary>
+			/// Buffered text output. A writer to a file flushes its buffer whenever it fills up,
+			/// a writer to memory grows its buffer instead.
+			/// </summary>
+			class Writer {
+				char* buffer = nullptr;
+				size_t capacity = 0;
+				size_t length = 0;
+				FILE* file = nullptr;
+				bool failed = false;
+				Writer(const Writer&);
+				Writer& operator=(const Writer&);
+			public:
+				/// <summary>
+				/// Writer to memory, see GetData.
+				/// </summary>
+				/// <param name="initialCapacity">Initial buffer size</param>
+				explicit Writer(size_t initialCapacity = 4096) {
+					capacity = initialCapacity ? initialCapacity : 1;
+					buffer = new char[capacity];
+				}
+				/// <summary>
+				/// Writer to an open file, which the caller closes after the writer flushed.
+				/// </summary>
+				/// <param name="target">File opened for writing</param>
+				/// <param name="bufferSize">Bytes gathered between two writes to the file</param>
+				Writer(FILE* target, size_t bufferSize = 64 * 1024) {
+					file = target;
+					failed = !target;
+					capacity = bufferSize ? bufferSize : 1;
+					buffer = new char[capacity];
+				}
+				~Writer() {
+					Flush();
+					delete[] buffer;
+				}
+				/// <summary>
+				/// Appends the specified bytes.
+				/// </summary>
+				/// <returns>False once a write to the file failed</returns>
+				bool Write(const char* data, size_t count) {
+					if (failed) {
+						return false;
+					}
+					if (length + count > capacity) {
+						if (file) {
+							if (!Flush()) {
+								return false;
+							}
+							if (count >= capacity) {
+								failed = fwrite(data, 1, count, file) != count;
+								return !failed;
+							}
+						}
+						else {
+							size_t grown = capacity * 2 > length + count ? capacity * 2 : length + count;
+							char* resized = new char[grown];
+							Marshal::Copy(buffer, resized, length);
+							delete[] buffer;
+							buffer = resized;
+							capacity = grown;
+						}
+					}
+					Marshal::Copy(data, buffer + length, count);
+					length += count;
+					return true;
+				}
+				bool Write(const char* text) {
+					return Write(text, sys::strlen(text));
+				}
+				bool Write(TOMLToken token) {
+					return Write(token.contents, (size_t)token.length);
+				}
+				bool Put(char character) {
+					return Write(&character, 1);
+				}
+				/// <summary>
+				/// Hands the buffered bytes to the file. Writers to memory keep them.
+				/// </summary>
+				/// <returns>False once a write to the file failed</returns>
+				bool Flush() {
+					if (file && length && !failed) {
+						failed = fwrite(buffer, 1, length, file) != length;
+						length = 0;
+					}
+					return !failed;
+				}
+				/// <summary>
+				/// Text written to memory, not null terminated. Unflushed bytes for writers to a file.
+				/// </summary>
+				const char* GetData() const {
+					return buffer;
+				}
+				size_t getLength() const {
+					return length;
+				}
+				bool Failed() const {
+					return failed;
+				}
+			};
+			/// <summary>
+			/// Writes parsed documents back to TOML text.
+			/// </summary>
+			class Serializer {
+			public:
+				enum Flags {
+					/// <summary>
+					/// Rebuild the text from the paths, entries and comments instead of writing Root::Data.
+					/// </summary>
+					Canonical = 1,
+				};
+				/// <summary>
+				/// Writes the document. Root::Data is kept up to date by Parser::Patch and Parser::Reparse,
+				/// so by default the text is written as is, in a single copy. Canonical rebuilds the text in
+				/// document order: full line comments, one header where the table changes and one
+				/// "key = value" line per entry. Blank lines, spacing and inline comments are not kept then.
+				/// </summary>
+				/// <param name="root">Parsed document</param>
+				/// <param name="writer">Target writer, left unflushed</param>
+				/// <param name="flags">Combination of Flags</param>
+				/// <returns>False if a write failed</returns>
+				static Boolean Write(const Root& root, Writer& writer, int flags = 0) {
+					if (!(flags & Canonical)) {
+						return writer.Write(root.Data, root.DataLength);
+					}
+					int entries = root.getLength();
+					int comments = root.commentCount();
+					int paths = root.pathCount();
+					int entry = 0;
+					int comment = 0;
+					int path = 0;
+					int current = -1;
+					bool written = false;
+					const size_t none = (size_t)-1;
+					while (entry < entries || comment < comments || path < paths) {
+						// Paths are interned: each header is written where its table first appears,
+						// and again before entries that come back to it after another table.
+						while (path < paths && root.Paths[path].IsRoot()) {
+							path++;
+						}
+						size_t pathAt = path < paths ? (size_t)(root.Paths[path].GetContents() - root.Data) : none;
+						int index = entry < entries ? root.TextIndex(entry) : -1;
+						size_t entryAt = index != -1 ? (size_t)root.Columns.KeyOffsets[index] : none;
+						size_t commentAt = comment < comments ? (size_t)root.Commentaries[comment].index : none;
+						if (pathAt == none && entryAt == none && commentAt == none) {
+							break;
+						}
+						if (commentAt <= entryAt && commentAt <= pathAt) {
+							writer.Put('#');
+							writer.Write(root.Data + commentAt + 1, (size_t)root.Commentaries[comment].length);
+							writer.Put('\n');
+							comment++;
+						}
+						else if (pathAt < entryAt) {
+							WriteHeader(root, path, writer, written);
+							current = path++;
+						}
+						else {
+							int table = root.Columns.Tables[index];
+							if (table != current && !root.Paths[table].IsRoot()) {
+								WriteHeader(root, table, writer, written);
+							}
+							current = table;
+							writer.Write(root.getKey(index));
+							writer.Write(" = ", 3);
+							writer.Write(root.getValue(index));
+							writer.Put('\n');
+							entry++;
+						}
+						written = true;
+					}
+					return !writer.Failed();
+				}
+				/// <summary>
+				/// Writes the document into a file. The text is written next to the target and renamed
+				/// over it, like Snapshot::Save.
+				/// </summary>
+				/// <returns>True if sucess.</returns>
+				static Boolean Save(const Root& root, const char* path, int flags = 0) {
+					if (!path) {
+						return false;
+					}
+					size_t length = sys::strlen(path);
+					char* temporary = new char[length + 5];
+					Marshal::Copy(path, temporary, length);
+					Marshal::Copy(".tmp", temporary + length, 5);
+					bool saved = false;
+					FILE* file = fopen(temporary, "wb");
+					if (file) {
+						{
+							Writer writer(file);
+							saved = Write(root, writer, flags) && writer.Flush();
+						}
+						saved = fclose(file) == 0 && saved;
+						saved = saved && rename(temporary, path) == 0;
+						if (!saved) {
+							remove(temporary);
+						}
+					}
+					delete[] temporary;
+					return saved;
+				}
+			private:
+				static void WriteHeader(const Root& root, int path, Writer& writer, bool separate) {
+					if (separate) {
+						writer.Put('\n');
+					}
+					writer.Put('[');
+					writer.Write(root.Paths[path].GetContents(), (size_t)root.Paths[path].GetLength());
+					writer.Write("]\n", 2);
+				}
+			};
+			typedef HResult TOMLHResultOrPtr;
+			/// <summary>
+			/// Tokens of a single classified line.
+			/// </summary>
+			struct LineToken {
+				/// <summary>
+				/// Comment, Path, or the kind of the value for entries.
+				/// </summary>
+				Kind kind;
+				/// <summary>
+				/// The line without its leading blanks and its line break.
+				/// </summary>
+				TOMLToken line;
+				/// <summary>
+				/// Path name for paths, key for entries.
+				/// </summary>
+				TOMLToken name;
+				/// <summary>
+				/// Trimmed value for entries without its inline comment, comment text for comments.
+				/// </summary>
+				TOMLToken value;
+				/// <summary>
+				/// The value is an array the content ends before closing, it takes the rest of the content.
+				/// </summary>
+				bool open;
+			};
+			/// <summary>
+			/// Monotonic clock of the parser statistics.
+			/// </summary>
+			struct ParseClock {
+				static uint64_t Nanoseconds() {
+#if defined(__CELLOS_LV2__)
+					return (uint64_t)sys_time_get_system_time() * 1000;
+#elif defined(CLOCK_MONOTONIC)
+					timespec now;
+					clock_gettime(CLOCK_MONOTONIC, &now);
+					return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+#else
+					return (uint64_t)clock() * (1000000000ull / CLOCKS_PER_SEC);
+#endif
+				}
+			};
+			/// <summary>
+			/// Counters filled by Parser::Parse when ParseOptions::statistics is set.
+			/// </summary>
+			struct ParseStatistics {
+				/// <summary>
+				/// Slots of kinds, the last one counts Unresolved entries of lazy parses.
+				/// </summary>
+				static const int KindSlots = Kind::Unknown + 2;
+				static const int ResultSlots = NotValidTryNext + 1;
+				size_t bytes;
+				size_t lines;
+				/// <summary>
+				/// Classified lines by kind: comments, paths and entries by the kind of their value.
+				/// </summary>
+				uint32_t kinds[KindSlots];
+				/// <summary>
+				/// Line outcomes: Sucess for classified lines, NotValidTryNext for lines without an assignment
+				/// and the decode errors of eager parses.
+				/// </summary>
+				uint32_t results[ResultSlots];
+				/// <summary>
+				/// Number-like values both number decoders rejected, handed to the legacy classifier.
+				/// </summary>
+				uint32_t fallthroughs;
+				/// <summary>
+				/// Line splitting, structural scanning and key and value spans.
+				/// </summary>
+				uint64_t tokenizeNanoseconds;
+				/// <summary>
+				/// Value kind detection and eager decoding.
+				/// </summary>
+				uint64_t classifyNanoseconds;
+				/// <summary>
+				/// Merging the parts of a parallel parse, sizing the root and building its indexes.
+				/// </summary>
+				uint64_t buildNanoseconds;
+				/// <summary>
+				/// Root::SizeOf of the parsed document.
+				/// </summary>
+				size_t memory;
+
+				ParseStatistics() {
+					Reset();
+				}
+				void Reset() {
+					sys::memset(this, 0, sizeof(ParseStatistics));
+				}
+				static int KindSlot(Kind kind) {
+					return kind == Kind::Unresolved ? KindSlots - 1 : (int)kind;
+				}
+				uint32_t getKindCount(Kind kind) const {
+					return kinds[KindSlot(kind)];
+				}
+				/// <summary>
+				/// Adds the counters of another part of the same document.
+				/// </summary>
+				void Merge(const ParseStatistics& part) {
+					bytes += part.bytes;
+					lines += part.lines;
+					for (int i = 0; i < KindSlots; i++) {
+						kinds[i] += part.kinds[i];
+					}
+					for (int i = 0; i < ResultSlots; i++) {
+						results[i] += part.results[i];
+					}
+					fallthroughs += part.fallthroughs;
+					tokenizeNanoseconds += part.tokenizeNanoseconds;
+					classifyNanoseconds += part.classifyNanoseconds;
+					buildNanoseconds += part.buildNanoseconds;
+				}
+			};
+			/// <summary>
+			/// Optional parser behaviours, all disabled by default.
+			/// </summary>
+			struct ParseOptions {
+				/// <summary>
+				/// Decode integer, decimal and boolean values while parsing, so the Entry getters
+				/// become plain loads and malformed values are reported by Parse.
+				/// </summary>
+				bool eagerDecode = false;
+				/// <summary>
+				/// Threads used by Parser::Parse. Above one, large documents are split at path headers
+				/// and the parts are parsed concurrently, then merged in document order.
+				/// </summary>
+				int threads = 1;
+				/// <summary>
+				/// Index the structure only: paths, keys and value spans. The kind of each value is left
+				/// Unresolved and is classified and decoded on the first access to the entry, through
+				/// Root::getKind or Root::EntryAt, so the parse cost follows the keys read rather than the
+				/// document size. Takes precedence over eagerDecode, value errors are not reported by Parse.
+				/// </summary>
+				bool lazy = false;
+				/// <summary>
+				/// Nullable, reset and filled by Parser::Parse. The parse loop is instantiated without the
+				/// counters and clock reads when it is null, so leaving it unset costs nothing. The phase
+				/// times of parallel parses add up the time of every worker.
+				/// </summary>
+				ParseStatistics* statistics = nullptr;
+				/// <summary>
+				/// Store the entries contiguously per table, in table ID order, with the range of each table
+				/// in Root::Ranges, so a table is iterated with a linear scan of the columns. Entry indexes
+				/// no longer follow the text then, Root::TextIndex maps text positions to them. Reparsing
+				/// a grouped document keeps it grouped.
+				/// </summary>
+				bool groupTables = false;
+			};
+
+			/// <summary>
+/// Encapsulates a dynamic instance of a TOML enumeration
+/// </summary>
+			class TOML {
+			public:
+				/// <summary>
+				/// Quick factory initialization
+				/// </summary>
+				/// <param name="data">Pointer to the raw TOML data</param>
+				TOML(char* data) {
+					Contents.ConstructorInit();  // Initialize the instance of Root container
+					Contents->SetData(data);     // Set the provided TOML data to the instance
+				}
+
+				/// <summary>
+				/// Default constructor, no initialization.
+				/// </summary>
+				TOML() {
+
+				}
+
+				/// <summary>
+				/// Dynamic and shared instance of the root container.
+				/// </summary>
+				System::Instance<Root> Contents;
+
+				/// <summary>
+				/// Get the count of the collected entries within the TOML structure.
+				/// </summary>
+				/// <returns>Number of entries in the TOML</returns>
+				size_t Count() {
+					if (Contents.NotNull()) {
+						return Contents->getLength();  // Returns the length of the entries in the root container
+					}
+					return 0;
+				}
+				/// <summary>
+				/// Get the used memory size by the root container of the document contents.
+				/// </summary>
+				/// <returns>size_t, see Root::SizeOf</returns>
+				size_t SizeOf() {
+					return Contents.NotNull() ? Contents->SizeOf() : 0;
+				}
+				/// <summary>
+				/// Index accessor to retrieve the entry at a specific index.
+				/// </summary>
+				/// <param name="index">Index of the entry</param>
+				/// <returns>A reference to the Entry object at the given index</returns>
+				Entry& operator [](size_t index) {
+					return *Contents->EntryAt((int)index);  // Access the entry at the specified index
+				}
+
+				/// <summary>
+				/// Get the original text data that was used to initialize the TOML object.
+				/// </summary>
+				/// <returns>Pointer to the raw data (nullable)</returns>
+				char* GetText() {
+					return Contents->Data;  // Return the original data used for parsing
+				}
+
+				/// <summary>
+				/// Find a path by its name within the TOML structure.
+				/// </summary>
+				/// <param name="name">Name of the path to search for</param>
+				/// <returns>Pointer to the matching PathName object or nullptr if not found</returns>
+				PathName* FindPathByName(const char* name) {
+					if (!name) {
+						return nullptr;
+					}
+					int index = Contents->FindPathIndex(name, (int)sys::strlen(name));  // Probe the table index
+					return index != -1 ? &Contents->Paths[index] : nullptr;  // Return null if no path matches
+				}
+				/// <summary>
+				/// Entries of a table in text order, see Root::getTableEntries. Parse with
+				/// ParseOptions::groupTables to make them a contiguous run of the columns.
+				/// </summary>
+				/// <param name="name">Table name as written in its header, the empty name is the root table</param>
+				/// <returns>Entry indexes for the Root column accessors, empty if no table matches</returns>
+				EntrySequence TableEntries(const char* name) {
+					EntrySequence none = { nullptr, 0, 0 };
+					if (!name || !Contents.NotNull()) {
+						return none;
+					}
+					return Contents->getTableEntries(Contents->FindPathIndex(name, (int)sys::strlen(name)));
+				}
+
+				/// <summary>
+				/// Find an entry by its full path within the TOML structure. Nested tables and dotted keys
+				/// are separated by '/' as well, see Root::FindEntryByPath.
+				/// </summary>
+				/// <param name="fullpath">Full path string to the entry (e.g., "path/to/entry")</param>
+				/// <returns>Pointer to the matching Entry object or nullptr if not found</returns>
+				Entry* FindEntryByPath(const char* fullpath) {
+					int index = FindEntryIndex(fullpath);
+					return index != -1 ? Contents->EntryAt(index) : nullptr;  // Return the found entry
+				}
+				/// <summary>
+				/// Find the index of an entry by its full path, without building its Entry view.
+				/// </summary>
+				/// <param name="fullpath">Full path string to the entry (e.g., "path/to/entry")</param>
+				/// <returns>Index for the Root column accessors or -1 if not found</returns>
+				int FindEntryIndex(const char* fullpath) {
+					if (!fullpath) {  // Ensure fullpath is valid
+						return -1;
+					}
+					int length = (int)sys::strlen(fullpath);
+					if (length > 0) {
+						int separator = Text::IndexOf(fullpath, '/');
+						if (separator != -1) {  // Check if the path contains a slash (indicating a hierarchical path)
+							return Contents->FindEntryByPath(fullpath, length);  // Resolve the nested tables and dotted keys
+						}
+						return Contents->FindKeyIndex(fullpath, length);  // If no slash, look for a direct entry match in any table
+					}
+					return -1;  // Return -1 if no entry matches
+				}
+				/// <summary>
+				/// Find a batch of entries by their full paths, as FindEntryByPath does for each of them.
+				/// Consecutive paths of the same table share its resolution, see Root::FindEntryIndexes.
+				/// </summary>
+				/// <param name="fullpaths">Full path strings, entries may be null</param>
+				/// <param name="count">Path count</param>
+				/// <param name="output">Receives the matching Entry objects, nullptr where not found</param>
+				/// <returns>Count of the paths found</returns>
+				int FindEntriesByPath(const char* const* fullpaths, int count, Entry** output) {
+					int indexes[Root::LookupBlock];
+					int found = 0;
+					for (int block = 0; block < count; block += Root::LookupBlock) {
+						int size = count - block < Root::LookupBlock ? count - block : Root::LookupBlock;
+						found += Contents->FindEntryIndexes(fullpaths + block, size, indexes);
+						for (int i = 0; i < size; i++) {
+							output[block + i] = indexes[i] != -1 ? Contents->EntryAt(indexes[i]) : nullptr;
+						}
+					}
+					return found;
+				}
+				/// <summary>
+				/// Find the indexes of a batch of entries by their full paths, without building Entry views.
+				/// </summary>
+				/// <param name="output">Receives the index of each path, or -1</param>
+				/// <returns>Count of the paths found</returns>
+				int FindEntryIndexes(const char* const* fullpaths, int count, int* output) {
+					return Contents->FindEntryIndexes(fullpaths, count, output);
+				}
+
+				/// <summary>
+				/// Maps the specified file read-only and parses it in place. The mapping stays alive
+				/// until Destroy, Data and every token of the document point into it.
+				/// </summary>
+				/// <param name="path">File path</param>
+				/// <param name="flags">Combination of MappedFile::Flags</param>
+				/// <returns>True if the file was mapped and parsed</returns>
+				Boolean LoadFile(const char* path, int flags = 0);
+				/// <summary>
+				/// Maps the specified file read-only and parses it in place with the specified options.
+				/// </summary>
+				/// <param name="outputStatus">Nullable, see Parser::Parse</param>
+				Boolean LoadFile(const char* path, int flags, const ParseOptions& options, TOMLResultStatus* outputStatus);
+				/// <summary>
+				/// Loads the specified file through a Snapshot image. The file is hashed, and when the image at
+				/// snapshotPath was written from the same contents it is mapped and used in place. Otherwise the
+				/// file is parsed as LoadFile does and the image is written again for the next load.
+				/// </summary>
+				/// <param name="path">File path</param>
+				/// <param name="snapshotPath">Image path, nullable to parse without writing an image</param>
+				/// <param name="flags">Combination of MappedFile::Flags, for both files</param>
+				/// <returns>True if the image was used or the file was parsed</returns>
+				Boolean LoadCached(const char* path, const char* snapshotPath, int flags = 0);
+				/// <summary>
+				/// Loads the specified file through a Snapshot image with the specified options. Images written
+				/// without decoded scalars are not used when eager decoding is requested.
+				/// </summary>
+				/// <param name="outputStatus">Nullable, see Parser::Parse</param>
+				Boolean LoadCached(const char* path, const char* snapshotPath, int flags, const ParseOptions& options, TOMLResultStatus* outputStatus);
+
+				/// <summary>
+				/// Destroy this instance of TOML, clearing its contents.
+				/// </summary>
+				/// <param name="wipe">Clears the document storage before releasing it</param>
+				void Destroy(bool wipe = false) {
+					Contents->Destroy(wipe);  // Clear the root container
+					Contents.Destroy();   // Destroy the instance itself
+				}
+
+				/// <summary>
+				/// Destructor for TOML instance.
+				/// </summary>
+				~TOML() {
+					__nop();  // No operation, placeholder for any future cleanup
+				};
+			};
+
+			/// <summary>
+			/// Field of a schema bound with Schema::Bind. Descriptors are literal types, an array of them
+			/// is built at compile time along with the hash of every (table, key) pair.
+			/// </summary>
+			/// <typeparam name="T">Target struct</typeparam>
+			template <typename T>
+			struct SchemaField {
+				enum Type {
+					Int32,
+					Int64,
+					Decimal,
+					Single,
+					Flag,
+					Text,
+				};
+				/// <summary>
+				/// Target member, by type.
+				/// </summary>
+				union Member {
+					int32_t T::* int32;
+					int64_t T::* int64;
+					double T::* decimal;
+					float T::* single;
+					bool T::* flag;
+					TOMLToken T::* text;
+					constexpr Member(int32_t T::* field) : int32(field) {}
+					constexpr Member(int64_t T::* field) : int64(field) {}
+					constexpr Member(double T::* field) : decimal(field) {}
+					constexpr Member(float T::* field) : single(field) {}
+					constexpr Member(bool T::* field) : flag(field) {}
+					constexpr Member(TOMLToken T::* field) : text(field) {}
+				};
+				/// <summary>
+				/// Value stored when the key is missing or does not hold the expected kind.
+				/// </summary>
+				union Default {
+					int64_t integer;
+					double decimal;
+					const char* text;
+					constexpr Default(int64_t value) : integer(value) {}
+					constexpr Default(double value) : decimal(value) {}
+					constexpr Default(const char* value) : text(value) {}
+				};
+				/// <summary>
+				/// TOMLHash::Of(table, key), computed at compile time.
+				/// </summary>
+				uint32_t hash;
+				/// <summary>
+				/// TOMLHash::Of(table), computed at compile time.
+				/// </summary>
+				uint32_t tableHash;
+				/// <summary>
+				/// Table name, empty for the root path.
+				/// </summary>
+				const char* table;
+				int tableLength;
+				const char* key;
+				int keyLength;
+				Type type;
+				Member member;
+				Default fallback;
+
+				constexpr SchemaField(const char* table, const char* key, int32_t T::* field, int32_t fallback)
+					: hash(TOMLHash::OfPath(table, key)), tableHash(TOMLHash::Fold(TOMLHash::Seed, table)), table(table), tableLength(TOMLHash::Measure(table)), key(key), keyLength(TOMLHash::Measure(key)),
+					type(Int32), member(field), fallback((int64_t)fallback) {}
+				constexpr SchemaField(const char* table, const char* key, int64_t T::* field, int64_t fallback)
+					: hash(TOMLHash::OfPath(table, key)), tableHash(TOMLHash::Fold(TOMLHash::Seed, table)), table(table), tableLength(TOMLHash::Measure(table)), key(key), keyLength(TOMLHash::Measure(key)),
+					type(Int64), member(field), fallback(fallback) {}
+				constexpr SchemaField(const char* table, const char* key, double T::* field, double fallback)
+					: hash(TOMLHash::OfPath(table, key)), tableHash(TOMLHash::Fold(TOMLHash::Seed, table)), table(table), tableLength(TOMLHash::Measure(table)), key(key), keyLength(TOMLHash::Measure(key)),
+					type(Decimal), member(field), fallback(fallback) {}
+				constexpr SchemaField(const char* table, const char* key, float T::* field, float fallback)
+					: hash(TOMLHash::OfPath(table, key)), tableHash(TOMLHash::Fold(TOMLHash::Seed, table)), table(table), tableLength(TOMLHash::Measure(table)), key(key), keyLength(TOMLHash::Measure(key)),
+					type(Single), member(field), fallback((double)fallback) {}
+				constexpr SchemaField(const char* table, const char* key, bool T::* field, bool fallback)
+					: hash(TOMLHash::OfPath(table, key)), tableHash(TOMLHash::Fold(TOMLHash::Seed, table)), table(table), tableLength(TOMLHash::Measure(table)), key(key), keyLength(TOMLHash::Measure(key)),
+					type(Flag), member(field), fallback((int64_t)fallback) {}
+				/// <summary>
+				/// Text field, receives the raw value token (quotes included) pointing into the document data.
+				/// </summary>
+				constexpr SchemaField(const char* table, const char* key, TOMLToken T::* field, const char* fallback)
+					: hash(TOMLHash::OfPath(table, key)), tableHash(TOMLHash::Fold(TOMLHash::Seed, table)), table(table), tableLength(TOMLHash::Measure(table)), key(key), keyLength(TOMLHash::Measure(key)),
+					type(Text), member(field), fallback(fallback) {}
+			};
+			/// <summary>
+			/// Fills a struct from a parsed document following a SchemaField array.
+			/// </summary>
+			/// <example>
+			/// struct Server { int32_t port; double ratio; TOMLToken host; };
+			/// static constexpr SchemaField&lt;Server&gt; ServerSchema[] = {
+			///     { "server", "port", &amp;Server::port, 8080 },
+			///     { "server", "ratio", &amp;Server::ratio, 1.0 },
+			///     { "server", "host", &amp;Server::host, "\"localhost\"" },
+			/// };
+			/// Schema&lt;Server&gt;::Bind(toml, ServerSchema, server);
+			/// </example>
+			template <typename T>
+			class Schema {
+				static bool Store(const SchemaField<T>& field, const Root& root, int index, T& target, TOMLResultStatus& status) {
+					TOMLToken value = root.getValue(index);
+					Kind kind = root.getKind(index);
+					const TOMLScalar* scalar = root.Columns.Scalars && root.Columns.Scalars[index].decoded ? &root.Columns.Scalars[index] : nullptr;
+					switch (field.type) {
+					case SchemaField<T>::Int32:
+					case SchemaField<T>::Int64: {
+						int64_t integer = 0;
+						if (kind != Kind::Integer) {
+							return false;
+						}
+						if (scalar) {
+							integer = scalar->integer;
+						}
+						else if (ScalarDecoder::Integer(value.contents, value.length, integer).StatusCode != Sucess) {
+							return false;
+						}
+						if (field.type == SchemaField<T>::Int32) {
+							if ((int64_t)(int32_t)integer != integer) {
+								status = TOMLResultStatus(Overflow);
+								return false;
+							}
+							target.*field.member.int32 = (int32_t)integer;
+						}
+						else {
+							target.*field.member.int64 = integer;
+						}
+						return true;
+					}
+					case SchemaField<T>::Decimal:
+					case SchemaField<T>::Single: {
+						double decimal = 0.0;
+						if (kind == Kind::Integer) {
+							int64_t integer = scalar ? scalar->integer : 0;
+							if (!scalar && ScalarDecoder::Integer(value.contents, value.length, integer).StatusCode != Sucess) {
+								return false;
+							}
+							decimal = (double)integer;
+						}
+						else if (kind == Kind::Double) {
+							if (scalar) {
+								decimal = scalar->decimal;
+							}
+							else if (ScalarDecoder::Decimal(value.contents, value.length, decimal).StatusCode != Sucess) {
+								return false;
+							}
+						}
+						else {
+							return false;
+						}
+						if (field.type == SchemaField<T>::Single) {
+							target.*field.member.single = (float)decimal;
+						}
+						else {
+							target.*field.member.decimal = decimal;
+						}
+						return true;
+					}
+					case SchemaField<T>::Flag: {
+						bool flag = false;
+						if (kind != Kind::Bool) {
+							return false;
+						}
+						if (scalar) {
+							flag = scalar->integer != 0;
+						}
+						else if (ScalarDecoder::Bool(value.contents, value.length, flag).StatusCode != Sucess) {
+							return false;
+						}
+						target.*field.member.flag = flag;
+						return true;
+					}
+					case SchemaField<T>::Text:
+						target.*field.member.text = value;
+						return true;
+					}
+					return false;
+				}
+				static void StoreDefault(const SchemaField<T>& field, T& target) {
+					switch (field.type) {
+					case SchemaField<T>::Int32:
+						target.*field.member.int32 = (int32_t)field.fallback.integer;
+						break;
+					case SchemaField<T>::Int64:
+						target.*field.member.int64 = field.fallback.integer;
+						break;
+					case SchemaField<T>::Decimal:
+						target.*field.member.decimal = field.fallback.decimal;
+						break;
+					case SchemaField<T>::Single:
+						target.*field.member.single = (float)field.fallback.decimal;
+						break;
+					case SchemaField<T>::Flag:
+						target.*field.member.flag = field.fallback.integer != 0;
+						break;
+					case SchemaField<T>::Text: {
+						TOMLToken token = { const_cast<char*>(field.fallback.text), field.fallback.text ? (int)sys::strlen(field.fallback.text) : 0 };
+						target.*field.member.text = token;
+						break;
+					}
+					}
+				}
+			public:
+				/// <summary>
+				/// Fills every field of the target. Each field costs one probe of the entry index with its
+				/// precomputed hash, the candidate is only confirmed by its lengths and bytes. The table of
+				/// a field is only looked up when it differs from the table of the previous field.
+				/// Missing fields, values of another kind and values out of the field range receive the
+				/// field default.
+				/// </summary>
+				/// <param name="toml">Parsed document</param>
+				/// <param name="fields">Field descriptors</param>
+				/// <param name="count">Field count</param>
+				/// <param name="target">Struct to fill</param>
+				/// <param name="outputStatus">Nullable. The first error along with the field index, Overflow for
+				/// an integer out of the range of its field</param>
+				/// <returns>Count of fields read from the document</returns>
+				static int Bind(TOML& toml, const SchemaField<T>* fields, int count, T& target, TOMLResultStatus* outputStatus = nullptr) {
+					const Root* root = toml.Contents.NotNull() ? toml.Contents.operator->() : nullptr;
+					const SchemaField<T>* resolved = nullptr;
+					int table = -1;
+					int found = 0;
+					bool failed = false;
+					for (int i = 0; i < count; i++) {
+						const SchemaField<T>& field = fields[i];
+						if (root && (!resolved || resolved->tableHash != field.tableHash || resolved->tableLength != field.tableLength ||
+							strncmp(resolved->table, field.table, field.tableLength) != 0)) {
+							table = root->FindPathIndex(field.tableHash, field.table, field.tableLength);
+							resolved = &field;
+						}
+						int index = table != -1 ? root->FindEntryIndex(field.hash, table, field.key, field.keyLength) : -1;
+						TOMLResultStatus status(Sucess);
+						if (index != -1 && Store(field, *root, index, target, status)) {
+							found++;
+							continue;
+						}
+						StoreDefault(field, target);
+						if (status.StatusCode != Sucess && !failed) {
+							failed = true;
+							if (outputStatus) {
+								*outputStatus = TOMLResultStatus(status.StatusCode, i);
+							}
+						}
+					}
+					return found;
+				}
+				template <int N>
+				static int Bind(TOML& toml, const SchemaField<T>(&fields)[N], T& target, TOMLResultStatus* outputStatus = nullptr) {
+					return Bind(toml, fields, N, target, outputStatus);
+				}
+			};
+
+			class Parser {
+			public:
+
+				// [Obsolete]
+				template <typename prim>
+				static bool IsFlaggedBy(prim& integerType, uint16_t bits) {
+					return (integerType & bits) != 0;
+				}
+				// [Obsolete]
+				template <typename prim>
+				static void SetFlag(prim& integerType, uint16_t bits, bool switchable) {
+					if (switchable)
+						integerType |= bits;
+					else
+						integerType &= ~bits;
+				}
+
+				static Boolean IsKeyValidCharacter(Char c) {
+					return
+						c.IsLetter() ||
+						c.IsDigit() ||
+						c.Equals('-') ||
+						c.Equals('_');
+				}
+				/// <summary>
+				/// Parses the valuable decimal (float/double) side of the equation.
+				/// </summary>
+				/// <param name="startIndex">Reference index of the line, for the final token to be stored in output</param>
+				/// <param name="segmentIterator">Data accessor iterator starting after the equal symbol.</param>
+				/// <param name="output">Output structure space for storing resulting analysis if operation completes.</param>
+				/// <returns></returns>
+				static TOMLResultStatus ParseDecimal(char* segmentIterator, Value& output) {
+					int length = MeasureValue(segmentIterator);
+					if (length == 0) {
+						return InvalidFloatFormat;
+					}
+					double decimal;
+					TOMLResultStatus result = ScalarDecoder::Decimal(segmentIterator, length, decimal);
+					if (result.StatusCode == Sucess) {
+						output.Build(Kind::Double, segmentIterator, length);
+					}
+					return result;
+				}
+				/// <summary>
+				/// Length of the value at the iterator, up to an inline comment or the line end, without trailing blanks.
+				/// </summary>
+				static int MeasureValue(char*& segmentIterator) {
+					while (*segmentIterator == ' ' || *segmentIterator == '\t') {
+						segmentIterator++;
+					}
+					int length = 0;
+					while (segmentIterator[length] && segmentIterator[length] != '#' && segmentIterator[length] != '\n' && segmentIterator[length] != '\r') {
+						length++;
+					}
+					while (length > 0 && (segmentIterator[length - 1] == ' ' || segmentIterator[length - 1] == '\t')) {
+						length--;
+					}
+					return length;
+				}
+				/// <summary>
+				/// Parses the valuable numeric (int) side of the equation.
+				/// </summary>
+				/// <param name="startIndex">Reference index of the line, for the final token to be stored in output</param>
+				/// <param name="segmentIterator">Data accessor iterator starting after the equal symbol.</param>
+				/// <param name="output">Output structure space for storing resulting analysis if operation completes.</param>
+				/// <returns></returns>
+				static TOMLResultStatus ParseNumeric(char* segmentIterator, Value& output) {
+					int length = MeasureValue(segmentIterator);
+					if (length == 0) {
+						return NotValidTryNext;
+					}
+					int64_t integer;
+					TOMLResultStatus result = ScalarDecoder::Integer(segmentIterator, length, integer);
+					if (result.StatusCode == Sucess) {
+						output.Build(Kind::Integer, segmentIterator, length);
+					}
+					return result;
+				}
+				/// <summary>
+				/// Parses the valuable boolean (bool) side of the equation.
+				/// </summary>
+				/// <param name="startIndex">Reference index of the line, for the final token to be stored in output</param>
+				/// <param name="segmentIterator">Data accessor iterator starting after the equal symbol.</param>
+				/// <param name="output">Output structure space for storing resulting analysis if operation completes.</param>
+				/// <returns></returns>
+				static TOMLResultStatus ParseBoolean(char* segmentIterator, Value& output) {
+					char* booleanIterator = segmentIterator;
+					char* resultLocation = nullptr;
+					int length = 0;
+
+					while (*booleanIterator != '#' && *booleanIterator && *booleanIterator != '\n' && *booleanIterator != '\r') {
+
+						bool containsPhrase = Text::StartsWith(booleanIterator, "true") || Text::StartsWith(booleanIterator, "false");
+						if (containsPhrase) {
+							resultLocation = booleanIterator;
+							break;
+						}
+						length++;
+						booleanIterator++;
+					}
+					if (resultLocation) {
+						char* phraseEndingCheckIterator = resultLocation;
+						byte TrailingSpacesButItsOk = 0;
+						bool correctEnding = false;
+						while (Char(*phraseEndingCheckIterator).IsLetter() &&
+							*phraseEndingCheckIterator != '#' &&
+							*phraseEndingCheckIterator != '-') {
+
+							if (*phraseEndingCheckIterator == '\n') {
+								correctEnding = true;
+								break;
+							}
+							else if (*phraseEndingCheckIterator == ' ') {
+								TrailingSpacesButItsOk++;
+							}
+							else {
+								output.Build(Kind::Bool, resultLocation, 6);
+								return { Sucess };
+							}
+							phraseEndingCheckIterator++;
+						}
+
+						return { Sucess, TrailingSpacesButItsOk };
+					}
+					return NotValidTryNext;
+				}
+				/// <summary>
+				/// Parses the valuable text (string) side of the equation.
+				/// </summary>
+				/// <param name="startIndex">Reference index of the line, for the final token to be stored in output</param>
+				/// <param name="segmentIterator">Data accessor iterator starting after the equal symbol.</param>
+				/// <param name="output">Output structure space for storing resulting analysis if operation completes.</param>
 				/// <returns></returns>
-				static TOMLResultStatus ParseDecimal(char* segmentIterator, Value& output) {
-					char* backup = segmentIterator;
-					int numerics = 0;
-					char* floatValuableBegin = nullptr;
-					bool foundDecimalGap = false;
-					while (*segmentIterator && *segmentIterator != '#' && *segmentIterator != '\n') {
-						Char current = *segmentIterator;
-						if ((current.Equals('.') && (!foundDecimalGap)) && numerics == 0) {
-							/// ERROR: TEXT CANNOT START WITH DECIMAL GAP.
-							return InvalidFloatFormat;
+				static TOMLResultStatus ParseString(char* segmentIterator) {
+
+					char* stringInitialIterator = segmentIterator;
+					char* stringIterator = segmentIterator;
+					char* stringStart = nullptr;
+					char* stringEnd = nullptr;
+
+					while (*stringIterator != '\n' && *stringIterator != '#' && *stringIterator != '\r') {
+						if (*stringIterator == '"' && stringStart == nullptr) {
+							stringStart = stringIterator + 1;
+						}
+						else if (*stringIterator == '"' && stringStart && stringEnd == nullptr) {
+							stringEnd = stringIterator;
+						}
+						else if (*stringIterator == '"' && stringStart && stringEnd) {
+							return { UnexpectedToken, 0 };
+						}
+
+						stringIterator++;
+					}
+					if (stringStart && stringEnd) {
+						return { Sucess, stringEnd - stringStart };
+					}
+					return { TOMLResultStatusCode::NotValidTryNext, 0 };
+				}
+				/// <summary>
+				/// Parses the valuable equation side of the equation.
+				/// </summary>
+				static HResult ParseEquation(char* contents, Value& output, TOMLResultStatus* outputResult) {
+					// Paso 1: encontrar el smbolo de asignacin '='
+					char* iterator = contents;
+					bool foundAssignment = false;
+					while (*iterator != '\n' && *iterator != '\0') { // Displace until end of line or eof for finding assignment operator.
+						if (*iterator == '=') { // Operator has been found break and start analysis.
+							foundAssignment = true;
+							break;
+						}
+						iterator++;
+					}
+					if (foundAssignment) {
+						int length = 0;
+						iterator++; // Move to the next char ignoring the starting '='
+						while (*iterator == ' ') { // Displace for all initially trailling space.
+							iterator++;
+						}
+						int EOL_Offset = 0;
+						bool commentFound = false;
+						char* defaultValuableIterator = iterator;
+						char* commentIterator = iterator;
+						char* integerIterator = iterator;
+						char* booleanIterator = iterator;
+						char* decimalIterator = iterator;
+						/// TRY FIND COMMENTARY
+						while (*commentIterator && *commentIterator != '\n') {
+							if (*commentIterator == '#') {
+								commentFound = true;
+							}
+							commentIterator++;
+							EOL_Offset++;
+						}
+						/// TRY TO PARSE THE VALUABLE SEGMENT INTO AN STRING
+						TOMLResultStatus stringAnalysis = ParseString(defaultValuableIterator);
+						*outputResult = stringAnalysis;
+						if (stringAnalysis.StatusCode == Sucess) {
+							/// IN THIS CASE, WE ASSIGNED ALREADY THE LENGTH OF THE RESULT INTO THE RESULT CODE. 
+							output.Build(Kind::String, defaultValuableIterator, stringAnalysis.Valuable);
+							return Sucess;
+						}
+						else {
+							TOMLResultStatus booleanAnalysis = ParseBoolean(booleanIterator, output);
+							*outputResult = booleanAnalysis;
+							if (booleanAnalysis.StatusCode == Sucess) {
+								return Sucess;
+							}
+							else {
+								TOMLResultStatus integralAnalysis = ParseNumeric(integerIterator, output);
+								*outputResult = integralAnalysis;
+								if (integralAnalysis.StatusCode == Sucess) {
+
+									return Sucess;
+								}
+								else {
+									TOMLResultStatus decimalAnalysis = ParseDecimal(decimalIterator, output);
+									*outputResult = decimalAnalysis;
+									if (decimalAnalysis.StatusCode == Sucess) {
+
+										return Sucess;
+									}
+									else {
+										return EUNEXPECTED;
+									}
+								}
+							}
+						}
+					}
+					else {
+						return EINVALID;
+					}
+
+				}
+				/// <summary>
+				/// Tries to determine the kind of the TOML line, then stores the information into 'output'
+				/// using the provided index, length and line information.
+				/// </summary>
+				/// <param name="ReferenceIndex">Character index of the current line</param>
+				/// <param name="line">The line section after the break</param>
+				/// <param name="lineLength">The length of the line until nullterminator or break</param>
+				/// <param name="output">Target resulting output</param>
+				/// <param name="outputStatus">Target resulting status</param>
+				/// <returns></returns>
+				static Kind ParseLine(char* line, size_t lineLength, Value& output, TOMLResultStatus* outputStatus) {
+					if (!line) {
+						return Kind::Unknown;
+					}
+					StructuralScanner scanner(line, lineLength);
+					LineToken token;
+					size_t lineEnd = lineLength;
+					if (!ClassifyLine(scanner, line, 0, lineEnd, token)) {
+						if (outputStatus) {
+							*outputStatus = TOMLResultStatus(NotValidTryNext);
+						}
+						return Kind::Unknown;
+					}
+					output.kind = token.kind;
+					output.token = token.kind == Path ? token.name : token.kind == Comment ? token.line : token.value;
+					if (outputStatus) {
+						*outputStatus = TOMLResultStatus(Sucess);
+					}
+					return token.kind;
+				}
+				/// <summary>
+				/// Classifies one line of a document. Shared by the document and the stream parsers so
+				/// both see the same paths, entries and comments.
+				/// </summary>
+				/// <param name="scanner">Structural index over the content</param>
+				/// <param name="content">Text the offsets refer to</param>
+				/// <param name="line">Offset of the line start</param>
+				/// <param name="lineEnd">Offset of the line break, or of the end of the content. Moved to the line break
+				/// of the last line of a multi-line array value.</param>
+				/// <param name="output">Target resulting tokens</param>
+				/// <param name="resolve">False leaves the kind of entries other than arrays Unresolved</param>
+				/// <returns>False for blank lines and lines without an assignment</returns>
+				static bool ClassifyLine(StructuralScanner& scanner, char* content, size_t line, size_t& lineEnd, LineToken& output, bool resolve = true) {
+					size_t end = lineEnd;
+					if (end > line && content[end - 1] == '\r') {
+						end--;
+					}
+					return ClassifyTrimmedLine(scanner, content, line, end, lineEnd, output, resolve);
+				}
+				/// <summary>
+				/// Classifies a line whose line break is already trimmed.
+				/// </summary>
+				static bool ClassifyTrimmedLine(StructuralScanner& scanner, char* content, size_t line, size_t lineEnd, size_t& rawLineEnd, LineToken& output, bool resolve = true) {
+					output.open = false;
+					size_t current = line;
+					while (current < lineEnd && content[current] == ' ') {
+						current++;
+					}
+					if (current == lineEnd) {
+						return false;
+					}
+					output.line = { content + current, (int)(lineEnd - current) };
+					output.name = { nullptr, 0 };
+					output.value = { nullptr, 0 };
+					if (content[current] == '#') {
+						output.kind = Kind::Comment;
+						output.value = { content + current + 1, (int)(lineEnd - current - 1) };
+						return true;
+					}
+					if (content[current] == '[') {
+						size_t close = scanner.Next(StructuralClose, current + 1, lineEnd);
+						output.kind = Kind::Path;
+						output.name = { content + current + 1, (int)(close - current - 1) };
+						return true;
+					}
+					size_t assignment = scanner.Next(StructuralEquals, current, lineEnd);
+					if (assignment == lineEnd || (assignment - current) >= 0xff) {
+						return false;
+					}
+					size_t keyEnd = current;
+					while (keyEnd < assignment && content[keyEnd] != ' ' && content[keyEnd] != '\t') {
+						keyEnd++;
+					}
+					output.name = { content + current, (int)(keyEnd - current) };
+					size_t valueStart = assignment + 1;
+					while (valueStart < lineEnd && (content[valueStart] == ' ' || content[valueStart] == '\t')) {
+						valueStart++;
+					}
+					size_t valueEnd;
+					if (valueStart < lineEnd && content[valueStart] == '[') {
+						// Arrays may go on over the following lines, the comment search starts after them.
+						size_t length = scanner.getLength();
+						bool closed;
+						size_t arrayEnd = valueStart + ArrayView::Span(content + valueStart, length - valueStart, closed);
+						output.open = !closed;
+						if (arrayEnd > lineEnd) {
+							rawLineEnd = scanner.Next(StructuralNewline, arrayEnd, length);
+							lineEnd = rawLineEnd;
+							if (lineEnd > arrayEnd && content[lineEnd - 1] == '\r') {
+								lineEnd--;
+							}
+							output.line.length = (int)(lineEnd - current);
+						}
+						valueEnd = scanner.NextComment(arrayEnd, lineEnd);
+					}
+					else {
+						valueEnd = scanner.NextComment(assignment + 1, lineEnd);
+					}
+					while (valueEnd > valueStart && (content[valueEnd - 1] == ' ' || content[valueEnd - 1] == '\t')) {
+						valueEnd--;
+					}
+					output.value = { content + valueStart, (int)(valueEnd - valueStart) };
+					if (resolve || (valueStart < valueEnd && content[valueStart] == '[')) {
+						output.kind = ClassifyValue(output.value.contents, output.value.length);
+					}
+					else {
+						output.kind = Kind::Unresolved;
+					}
+					return true;
+				}
+
+				static Kind GetKindForPairValueString(char* valueString) {
+					int length = Text::LineLength(valueString);
+					int index = 0;
+					while (*valueString == ' ') {
+						index++;
+						valueString++;
+					}
+					if (safest_compare(valueString, BOOLEAN_FALSE_LITERAL) ||
+						safest_compare(valueString, BOOLEAN_TRUE_LITERAL)) {
+						return Kind::Bool;
+					}
+					else {
+						int letters_c = Text::countLettersInLine(valueString);
+						int numbers_c = Text::countNumbersInLine(valueString);
+						int spaces_c = Text::countSpacesInLine(valueString);
+						if (letters_c == 0 && numbers_c > 0) {
+							if (Text::couldBeIntegerRepresentation(valueString)) {
+								return Kind::Integer;
+							}
+							else if (Text::couldBeFloatValueRepresentation(valueString, '.')) {
+								return Kind::Double;
+							}
+						}
+						if (*valueString == '[') {
+							return Kind::Array;
+						}
+						else {
+							char commaEnding = 0;
+							char commaStarting = 0;
+							int textEnd = 0;
+							int textStart = 0;
+							for (int i = length - 1; i > 0; i--) {
+								if (valueString[i] == '"') {
+									commaEnding = '"';
+									textEnd = i;
+									break;
+								}
+								else if (valueString[i] == '\'') {
+									commaEnding = '\'';
+									textEnd = i;
+									break;
+								}
+							}
+							for (int i = 0; i < length; i++) {
+								if (valueString[i] == '"') {
+									commaStarting = '"';
+									textStart = i;
+									break;
+								}
+								else if (valueString[i] == '\'') {
+									commaStarting = '\'';
+									textStart = i;
+									break;
+								}
+							}
+							if (commaEnding == commaStarting && (commaStarting > 0 && commaEnding > 0)) {
+								return Kind::String;
+							}
+							return Kind::Unknown;
+						}
+					}
+
+				}
+
+				/// <summary>
+				/// Classifies the valuable side of an entry line.
+				/// </summary>
+				/// <param name="value">Value token, after the assignment operator</param>
+				/// <param name="length">Value token length</param>
+				static Kind ClassifyValue(char* value, int length) {
+					return ClassifyValue(value, length, nullptr);
+				}
+				/// <param name="fallthroughs">Nullable, counts number-like values the number decoders rejected</param>
+				static Kind ClassifyValue(char* value, int length, uint32_t* fallthroughs) {
+					if (length > 0 && value[0] == '[') {
+						return Kind::Array;
+					}
+					if (length > 0 && (Char(value[0]).IsDigit() || value[0] == '+' || value[0] == '-' || value[0] == 'i' || value[0] == 'n')) {
+						int64_t integer;
+						double decimal;
+						if (ScalarDecoder::Integer(value, length, integer).StatusCode != UnexpectedToken) {
+							return Kind::Integer;
+						}
+						if (ScalarDecoder::Decimal(value, length, decimal).StatusCode == Sucess) {
+							return Kind::Double;
+						}
+						if (fallthroughs) {
+							(*fallthroughs)++;
+						}
+					}
+					char buffer[64];
+					int copied = length < 63 ? length : 63;
+					Marshal::Copy(value, buffer, copied);
+					buffer[copied] = 0;
+					Kind kind = GetKindForPairValueString(buffer);
+					Marshal::Clear(buffer);
+					return kind;
+				}
+				/// <summary>
+				/// Decodes the trimmed value token of an integer, decimal or boolean entry.
+				/// </summary>
+				/// <returns>See ScalarDecoder::Decode</returns>
+				static TOMLResultStatus DecodeScalar(Kind kind, const char* value, int length, TOMLScalar& output) {
+					return ScalarDecoder::Decode(kind, value, length, output);
+				}
+				/// <summary>
+				/// Parses the document in a single pass, staging the results until the final counts are known.
+				/// </summary>
+				/// <param name="content">Document text</param>
+				/// <param name="content_length">Document length, the text does not need to be null terminated</param>
+				/// <param name="toml">Target document</param>
+				static Boolean Parse(char* content, size_t content_length, TOML* toml) {
+					return Parse(content, content_length, toml, ParseOptions(), nullptr);
+				}
+				/// <summary>
+				/// Parses the document in a single pass, staging the results until the final counts are known.
+				/// </summary>
+				/// <param name="content">Document text</param>
+				/// <param name="content_length">Document length, the text does not need to be null terminated</param>
+				/// <param name="toml">Target document</param>
+				/// <param name="options">Parser behaviours</param>
+				/// <param name="outputStatus">Nullable, receives the first value error along with its offset in the document</param>
+				/// <returns>False if the content is null or a value could not be decoded. The document is built in both cases.</returns>
+				static Boolean Parse(char* content, size_t content_length, TOML* toml, const ParseOptions& options, TOMLResultStatus* outputStatus) {
+					DocumentBuilder builder;
+					return Parse(content, content_length, toml, options, outputStatus, builder);
+				}
+				/// <summary>
+				/// Parses the document with the specified builder, reset first. The builder keeps its storage
+				/// afterwards, so parsing many documents with one builder stages them without allocating.
+				/// </summary>
+				static Boolean Parse(char* content, size_t content_length, TOML* toml, const ParseOptions& options, TOMLResultStatus* outputStatus, DocumentBuilder& builder) {
+					if (!content) {
+						return false;
+					}
+					TOMLResultStatus decoding(Sucess);
+					builder.Reset();
+					ParseStatistics* statistics = options.statistics;
+					if (statistics) {
+						statistics->Reset();
+						statistics->bytes = content_length;
+					}
+					if (options.threads > 1 && content_length >= 2 * ParallelChunkSize) {
+						ParseParallel(content, content_length, builder, options, decoding);
+					}
+					else {
+						StructuralScanner scanner(content, content_length);
+						ParseRange(scanner, content, 0, content_length, builder, options, decoding, statistics);
+					}
+					uint64_t building = statistics ? ParseClock::Nanoseconds() : 0;
+					if (outputStatus) {
+						*outputStatus = decoding;
+					}
+					if (options.lazy || options.eagerDecode) {
+						builder.KeepScalars();
+					}
+					toml->Contents->SetData(content, content_length);
+					builder.Finalize(*toml->Contents.operator->(), options.groupTables);
+					toml->Contents->BuildIndex();
+					if (statistics) {
+						statistics->buildNanoseconds += ParseClock::Nanoseconds() - building;
+						statistics->memory = toml->Contents->SizeOf();
+					}
+					return decoding.StatusCode == Sucess;
+				}
+				/// <summary>
+				/// Replaces a byte range of a parsed document and updates it. The first edit copies the text into
+				/// a buffer owned by the document, with slack so that later edits rarely reallocate it.
+				/// Edits whose lines keep their keys, comments and paths only re-tokenize those lines and shift
+				/// the offsets after them, entry views stay valid then. Other edits reparse the whole document,
+				/// which releases the entry views.
+				/// </summary>
+				/// <param name="toml">Parsed document</param>
+				/// <param name="offset">Start of the replaced range in the current text</param>
+				/// <param name="length">Length of the replaced range</param>
+				/// <param name="replacement">Replacement text, nullable when replacementLength is zero</param>
+				/// <param name="replacementLength">Replacement text length</param>
+				/// <param name="options">Parser behaviours, also used by the full reparse</param>
+				/// <param name="outputStatus">Nullable, as in Parse. Valuable is the new text length on sucess.</param>
+				/// <returns>False if the range is outside the text, otherwise as Parse</returns>
+				static Boolean Reparse(TOML* toml, size_t offset, size_t length, const char* replacement, size_t replacementLength, const ParseOptions& options, TOMLResultStatus* outputStatus) {
+					if (!toml || !toml->Contents.NotNull()) {
+						return false;
+					}
+					Root& root = *toml->Contents.operator->();
+					size_t size = root.DataLength;
+					if (!root.Data || offset > size || length > size - offset || (!replacement && replacementLength)) {
+						if (outputStatus) {
+							*outputStatus = TOMLResultStatus(UnexpectedToken);
+						}
+						return false;
+					}
+					// Whole lines touched by the replaced range, as they were before the edit.
+					size_t begin = offset;
+					while (begin > 0 && root.Data[begin - 1] != '\n') {
+						begin--;
+					}
+					size_t end = offset + length;
+					while (end < size && root.Data[end] != '\n') {
+						end++;
+					}
+					if (end < size) {
+						end++;
+					}
+					// The columns of a snapshot go away with its mapping, such documents are always reparsed.
+					bool readOnly = root.ReadOnly;
+					char* previous = new char[end - begin + 1];
+					Marshal::Copy(root.Data + begin, previous, end - begin);
+					previous[end - begin] = 0;
+
+					size_t resized = size - length + replacementLength;
+					if (root.OwnedCapacity < resized + 1) {
+						root.OwnData(resized + resized / 8 + 64);
+					}
+					memmove(root.Data + offset + replacementLength, root.Data + offset + length, size - offset - length);
+					if (replacementLength) {
+						Marshal::Copy(replacement, root.Data + offset, replacementLength);
+					}
+					root.Data[resized] = 0;
+					root.DataLength = resized;
+
+					TOMLResultStatus decoding(Sucess);
+					bool patched = !readOnly && PatchLines(root, previous, end - begin, begin, end - length + replacementLength, (int64_t)replacementLength - (int64_t)length, options, decoding);
+					delete[] previous;
+					if (!patched) {
+						ParseOptions layout = options;
+						layout.groupTables = layout.groupTables || root.isGrouped();
+						return Parse(root.Data, resized, toml, layout, outputStatus);
+					}
+					if (outputStatus) {
+						*outputStatus = decoding.StatusCode == Sucess ? TOMLResultStatus(Sucess, (HResult)resized) : decoding;
+					}
+					return decoding.StatusCode == Sucess;
+				}
+				static Boolean Reparse(TOML* toml, size_t offset, size_t length, const char* replacement, size_t replacementLength) {
+					return Reparse(toml, offset, length, replacement, replacementLength, ParseOptions(), nullptr);
+				}
+				/// <summary>
+				/// Replaces the value of an entry. A single line replacement without a comment sign that fits
+				/// the current value is copied over it in place and padded with spaces, only that entry is
+				/// updated then. The other replacements, and documents whose text is mapped or borrowed from
+				/// a snapshot, go through Reparse.
+				/// </summary>
+				/// <param name="toml">Parsed document</param>
+				/// <param name="index">Entry index</param>
+				/// <param name="value">Replacement value, as written in a document</param>
+				/// <param name="length">Replacement value length</param>
+				/// <param name="options">Parser behaviours, used when the value is reparsed</param>
+				/// <param name="outputStatus">Nullable, as in Reparse</param>
+				/// <returns>False if the index is out of range or the value could not be decoded, otherwise as Reparse</returns>
+				static Boolean Patch(TOML* toml, int index, const char* value, size_t length, const ParseOptions& options, TOMLResultStatus* outputStatus) {
+					if (!toml || !toml->Contents.NotNull() || index < 0 || index >= toml->Contents->getLength() || (!value && length)) {
+						if (outputStatus) {
+							*outputStatus = TOMLResultStatus(UnexpectedToken);
+						}
+						return false;
+					}
+					Root& root = *toml->Contents.operator->();
+					TOMLToken current = root.getValue(index);
+					bool fits = !root.ReadOnly && (root.OwnedCapacity || root.Data != root.Mapping.GetData()) &&
+						length > 0 && length <= (size_t)current.length;
+					for (size_t i = 0; fits && i < length; i++) {
+						fits = value[i] != '\n' && value[i] != '\r' && value[i] != '#';
+					}
+					if (!fits) {
+						return Reparse(toml, (size_t)(current.contents - root.Data), (size_t)current.length, value, length, options, outputStatus);
+					}
+					Marshal::Copy(value, current.contents, length);
+					sys::memset(current.contents + length, ' ', (size_t)current.length - length);
+					Kind kind = ClassifyValue(current.contents, (int)length);
+					TOMLResultStatus decoding(Sucess);
+					if (root.Columns.Scalars) {
+						TOMLScalar scalar = TOMLScalar::None();
+						TOMLResultStatus result = DecodeScalar(kind, current.contents, (int)length, scalar);
+						if (result.StatusCode != Sucess && result.StatusCode != NotValidTryNext) {
+							decoding = TOMLResultStatus(result.StatusCode, (HResult)(current.contents - root.Data));
+						}
+						root.Columns.Scalars[index] = scalar;
+					}
+					root.Columns.ValueLengths[index] = (uint32_t)length;
+					root.Columns.Kinds[index] = (uint8_t)kind;
+					root.RefreshView(index);
+					if (outputStatus) {
+						*outputStatus = decoding.StatusCode == Sucess ? TOMLResultStatus(Sucess, (HResult)root.DataLength) : decoding;
+					}
+					return decoding.StatusCode == Sucess;
+				}
+				static Boolean Patch(TOML* toml, int index, const char* value, size_t length) {
+					return Patch(toml, index, value, length, ParseOptions(), nullptr);
+				}
+				/// <summary>
+				/// Smallest part handed to a worker by the parallel parse, smaller documents are parsed serially.
+				/// </summary>
+				static const size_t ParallelChunkSize = 256 * 1024;
+			private:
+				/// <summary>
+				/// Next line of [line, end) that ClassifyLine recognizes, advancing line past it.
+				/// </summary>
+				static bool NextLine(StructuralScanner& scanner, char* content, size_t& line, size_t end, LineToken& token, bool resolve = true) {
+					while (line < end) {
+						size_t newline = scanner.Next(StructuralNewline, line, end);
+						bool found = ClassifyLine(scanner, content, line, newline, token, resolve);
+						line = newline + 1;
+						if (found) {
+							return true;
+						}
+					}
+					return false;
+				}
+				/// <summary>
+				/// Updates the root in place for an edit that changed the lines [begin, end) of the new text,
+				/// which were the previous text before. Gives up as soon as the lines differ by more than
+				/// their values and comment texts, the root is left half updated then and must be reparsed.
+				/// </summary>
+				/// <param name="delta">Length difference between the new and the previous text</param>
+				/// <param name="options">Lazy edits leave the patched values Unresolved, eager ones need the scalars column</param>
+				static bool PatchLines(Root& root, char* previous, size_t previousLength, size_t begin, size_t end, int64_t delta, const ParseOptions& options, TOMLResultStatus& decoding) {
+					EntryColumns& columns = root.Columns;
+					if (options.eagerDecode && !options.lazy && !columns.Scalars) {
+						return false;
+					}
+					int entries = root.getLength();
+					int comments = root.commentCount();
+					// Entries are walked by text position, which is their index unless grouped by table.
+					int entry = 0;
+					for (int step = entries; step > 0;) {
+						int half = step / 2;
+						if (columns.KeyOffsets[root.TextIndex(entry + half)] < begin) {
+							entry += half + 1;
+							step -= half + 1;
+						}
+						else {
+							step = half;
+						}
+					}
+					if (entry > 0) {
+						// The edit is inside a multi-line array of the previous entry. An array left open runs to
+						// the end of the text, an edit right after it may be the one that closes it.
+						int last = root.TextIndex(entry - 1);
+						size_t valueEnd = (size_t)columns.ValueOffsets[last] + columns.ValueLengths[last];
+						bool open = columns.ValueLengths[last] && root.Data[columns.ValueOffsets[last]] == '[' && root.Data[valueEnd - 1] != ']';
+						if (valueEnd > begin || (open && valueEnd >= begin)) {
+							return false;
+						}
+					}
+					int comment = 0;
+					while (comment < comments && (size_t)root.Commentaries[comment].index < begin) {
+						comment++;
+					}
+
+					StructuralScanner before(previous, previousLength);
+					StructuralScanner after(root.Data, root.DataLength);
+					size_t beforeLine = 0;
+					size_t afterLine = begin;
+					LineToken old, updated;
+					for (;;) {
+						bool hasOld = NextLine(before, previous, beforeLine, previousLength, old);
+						bool hasUpdated = NextLine(after, root.Data, afterLine, end, updated, !options.lazy);
+						if (hasOld != hasUpdated) {
+							return false;
+						}
+						if (!hasOld) {
+							break;
 						}
-						else if ((current.Equals('.') && (!foundDecimalGap)) && numerics > 0) {
-							foundDecimalGap = true;
+						if (old.open || afterLine > end + 1 || (afterLine > end && end < root.DataLength)) {
+							return false;
 						}
-						else if ((current.Equals('.') && (foundDecimalGap)) && numerics > 0) {
-							return { FloatingPointUnexpectedDecimalGap };
+						if (old.kind == Kind::Path || updated.kind == Kind::Path || (old.kind == Kind::Comment) != (updated.kind == Kind::Comment)) {
+							return false;
 						}
-						else if (current.IsDigit()) {
-							if (floatValuableBegin == nullptr) {
-								floatValuableBegin = segmentIterator;
+						if (updated.kind == Kind::Comment) {
+							if (comment >= comments || (size_t)root.Commentaries[comment].index != begin + (old.line.contents - previous)) {
+								return false;
 							}
-							numerics++;
+							root.Commentaries[comment].index = (int)(updated.line.contents - root.Data);
+							root.Commentaries[comment].length = updated.value.length;
+							comment++;
+							continue;
 						}
-						else if (current.IsLetter()) {
-							/// ERROR: TEXT CANNOT CONTAINS LETTERS.
-							return InvalidFloatFormat;
+						int index = entry < entries ? root.TextIndex(entry) : -1;
+						if (index == -1 || columns.KeyOffsets[index] != begin + (old.name.contents - previous) ||
+							old.name.length != updated.name.length || strncmp(old.name.contents, updated.name.contents, old.name.length) != 0) {
+							return false;
 						}
-						segmentIterator++;
+						columns.KeyOffsets[index] = (uint32_t)(updated.name.contents - root.Data);
+						columns.ValueOffsets[index] = (uint32_t)(updated.value.contents - root.Data);
+						columns.ValueLengths[index] = (uint32_t)updated.value.length;
+						columns.Kinds[index] = (uint8_t)updated.kind;
+						if (columns.Scalars) {
+							TOMLScalar scalar = TOMLScalar::None();
+							TOMLResultStatus result = DecodeScalar(updated.kind, updated.value.contents, updated.value.length, scalar);
+							if (result.StatusCode != Sucess && result.StatusCode != NotValidTryNext && decoding.StatusCode == Sucess) {
+								decoding = TOMLResultStatus(result.StatusCode, (HResult)(updated.value.contents - root.Data));
+							}
+							columns.Scalars[index] = scalar;
+						}
+						entry++;
 					}
-					if (floatValuableBegin && numerics > 0) {
 
-						char buffer[32];
-						for (int i = 0; i < numerics; i++) {
-							buffer[i] = floatValuableBegin[i];
+					// Everything after the edited lines moved by delta.
+					size_t shiftedFrom = (size_t)((int64_t)end - delta);
+					for (int i = entry; i < entries; i++) {
+						int index = root.TextIndex(i);
+						columns.KeyOffsets[index] = (uint32_t)((int64_t)columns.KeyOffsets[index] + delta);
+						columns.ValueOffsets[index] = (uint32_t)((int64_t)columns.ValueOffsets[index] + delta);
+					}
+					for (int i = comment; i < comments; i++) {
+						root.Commentaries[i].index = (int)(root.Commentaries[i].index + delta);
+					}
+					for (int i = 0; i < root.pathCount(); i++) {
+						PathName& path = root.Paths[i];
+						if (!path.IsRoot() && (size_t)(path.GetContents() - root.Data) >= shiftedFrom) {
+							path = PathName(path.GetContents() + delta, path.GetLength());
 						}
-						return Text::couldBeFloatValueRepresentation(buffer, '.', false) ? Sucess : InvalidFloatFormat;
 					}
-					return InvalidFloatFormat;
+					root.RefreshViews();
+					return true;
 				}
 				/// <summary>
-				/// Parses the valuable numeric (int) side of the equation.
+				/// Stages the lines starting in [begin, end) into the builder.
 				/// </summary>
-				/// <param name="startIndex">Reference index of the line, for the final token to be stored in output</param>
-				/// <param name="segmentIterator">Data accessor iterator starting after the equal symbol.</param>
-				/// <param name="output">Output structure space for storing resulting analysis if operation completes.</param>
-				/// <returns></returns>
-				static TOMLResultStatus ParseNumeric(char* segmentIterator, Value& output) {
-					char* iterator = segmentIterator;
-					while (*segmentIterator == ' ') {
-						segmentIterator++;
+				/// <param name="decoding">Receives the first value error of the range, left untouched otherwise</param>
+				/// <param name="statistics">Nullable, receives the counters of the range</param>
+				/// <returns>Offset after the last line, past end when a multi-line array crosses it</returns>
+				static size_t ParseRange(StructuralScanner& scanner, char* content, size_t begin, size_t end, DocumentBuilder& builder, const ParseOptions& options, TOMLResultStatus& decoding, ParseStatistics* statistics) {
+					if (statistics) {
+						return StageLines<true>(scanner, content, begin, end, builder, options, decoding, statistics);
 					}
-					char* valuableBegin = nullptr;
-					int numerics = 0;
-					while (*segmentIterator != '#' && *segmentIterator != '\n' && *segmentIterator != '\r') {
-						Char cc = *segmentIterator;
-						if (cc.IsDigit()) {
-							if (valuableBegin == nullptr) {
-								valuableBegin = segmentIterator;
+					return StageLines<false>(scanner, content, begin, end, builder, options, decoding, nullptr);
+				}
+				/// <summary>
+				/// Parse loop of ParseRange, Instrumented adds the counters and the phase clock reads.
+				/// </summary>
+				template <bool Instrumented>
+				static size_t StageLines(StructuralScanner& scanner, char* content, size_t begin, size_t end, DocumentBuilder& builder, const ParseOptions& options, TOMLResultStatus& decoding, ParseStatistics* statistics) {
+					LineToken token;
+					size_t line = begin;
+					uint64_t started = Instrumented ? ParseClock::Nanoseconds() : 0;
+					uint64_t classifying = 0;
+					while (line < end) {
+						size_t newline = scanner.Next(StructuralNewline, line, end);
+						// Instrumented loops classify the values apart, so their time is measured on its own.
+						if (ClassifyLine(scanner, content, line, newline, token, !options.lazy && !Instrumented)) {
+							if (token.kind == Kind::Comment) {
+								builder.AddComment((int)(token.line.contents - content), token.value.length);
+							}
+							else if (token.kind == Kind::Path) {
+								builder.AddPath(token.name.contents, token.name.length);
+							}
+							else {
+								uint64_t classified = 0;
+								if (Instrumented) {
+									classified = ParseClock::Nanoseconds();
+									if (token.kind == Kind::Unresolved && !options.lazy) {
+										token.kind = ClassifyValue(token.value.contents, token.value.length, &statistics->fallthroughs);
+									}
+								}
+								TOMLScalar scalar = TOMLScalar::None();
+								TOMLResultStatusCode outcome = Sucess;
+								if (options.eagerDecode && !options.lazy) {
+									TOMLResultStatus result = DecodeScalar(token.kind, token.value.contents, token.value.length, scalar);
+									if (result.StatusCode != Sucess && result.StatusCode != NotValidTryNext) {
+										outcome = result.StatusCode;
+										if (decoding.StatusCode == Sucess) {
+											decoding = TOMLResultStatus(result.StatusCode, (HResult)(token.value.contents - content));
+										}
+									}
+								}
+								if (Instrumented) {
+									classifying += ParseClock::Nanoseconds() - classified;
+									statistics->results[outcome]++;
+									statistics->kinds[ParseStatistics::KindSlot(token.kind)]++;
+								}
+								builder.AddEntry(token.kind, token.name, token.value, scalar);
+							}
+							if (Instrumented && (token.kind == Kind::Comment || token.kind == Kind::Path)) {
+								statistics->results[Sucess]++;
+								statistics->kinds[token.kind]++;
 							}
-							numerics++;
 						}
-						else if (cc.Equals(' ') && numerics > 0) { // avoid starting with spaces or after weird symbols
-							break;
+						else if (Instrumented && !IsBlankLine(content, line, newline)) {
+							statistics->results[NotValidTryNext]++;
 						}
-						else {
-							return { UnexpectedToken, 0 };
+						if (Instrumented) {
+							statistics->lines++;
 						}
-						segmentIterator++;
+						line = newline + 1;
+					}
+					if (Instrumented) {
+						statistics->classifyNanoseconds += classifying;
+						statistics->tokenizeNanoseconds += ParseClock::Nanoseconds() - started - classifying;
+					}
+					return line;
+				}
+				static bool IsBlankLine(const char* content, size_t line, size_t end) {
+					while (line < end && (content[line] == ' ' || content[line] == '\t' || content[line] == '\r')) {
+						line++;
 					}
-					if (valuableBegin != nullptr) {
-						char buffer[32];
-						sys::memset(buffer, 0, 32);
-						for (int i = 0; i < numerics; i++) {
-							buffer[i] = valuableBegin[i];
+					return line == end;
+				}
+				/// <summary>
+				/// Offset of the first line at or after from that opens a path header once its leading spaces are
+				/// skipped. Tabs are not skipped, like in ClassifyTrimmedLine, so the parts split where the serial
+				/// parse sees a header.
+				/// </summary>
+				/// <returns>The offset, or length if there is no header left</returns>
+				static size_t NextHeaderLine(StructuralScanner& scanner, const char* content, size_t from, size_t length) {
+					size_t bracket = scanner.Next(StructuralOpen, from, length);
+					while (bracket < length) {
+						size_t line = bracket;
+						while (line > 0 && content[line - 1] == ' ') {
+							line--;
 						}
-						auto res = Text::couldBeIntegerRepresentation(buffer) ? Sucess : NotValidTryNext;;
-						if (res == Sucess) {
-							output.Build(Kind::Integer, valuableBegin, numerics);
+						if (line == 0 || content[line - 1] == '\n') {
+							if (line >= from) {
+								return line;
+							}
 						}
-						return res;
+						bracket = scanner.Next(StructuralOpen, bracket + 1, length);
 					}
-					return NotValidTryNext;
+					return length;
 				}
 				/// <summary>
-				/// Parses the valuable boolean (bool) side of the equation.
+				/// One part of a parallel parse, the text between two path headers.
 				/// </summary>
-				/// <param name="startIndex">Reference index of the line, for the final token to be stored in output</param>
-				/// <param name="segmentIterator">Data accessor iterator starting after the equal symbol.</param>
-				/// <param name="output">Output structure space for storing resulting analysis if operation completes.</param>
-				/// <returns></returns>
-				static TOMLResultStatus ParseBoolean(char* segmentIterator, Value& output) {
-					char* booleanIterator = segmentIterator;
-					char* resultLocation = nullptr;
-					int length = 0;
-
-					while (*booleanIterator != '#' && *booleanIterator && *booleanIterator != '\n' && *booleanIterator != '\r') {
-
-						bool containsPhrase = Text::StartsWith(booleanIterator, "true") || Text::StartsWith(booleanIterator, "false");
-						if (containsPhrase) {
-							resultLocation = booleanIterator;
-							break;
+				struct ParallelPart {
+					char* content;
+					size_t length;
+					size_t begin;
+					size_t end;
+					const ParseOptions* options;
+					DocumentBuilder builder;
+					TOMLResultStatus decoding = TOMLResultStatus(Sucess);
+					ParseStatistics statistics;
+					/// <summary>
+					/// Offset after the last line staged.
+					/// </summary>
+					size_t reached;
+				};
+				static void ParsePart(void* context, int index) {
+					ParallelPart& part = ((ParallelPart*)context)[index];
+					StructuralScanner scanner(part.content, part.length);
+					part.reached = ParseRange(scanner, part.content, part.begin, part.end, part.builder, *part.options, part.decoding,
+						part.options->statistics ? &part.statistics : nullptr);
+				}
+				/// <summary>
+				/// Splits the document at path header lines, stages the parts on a TaskPool and appends
+				/// them to the builder in document order. Every part but the first starts with its own header,
+				/// so the parts never depend on each other and the merge gives the serial result.
+				/// </summary>
+				static void ParseParallel(char* content, size_t length, DocumentBuilder& builder, const ParseOptions& options, TOMLResultStatus& decoding) {
+					// A few parts per thread, so a part crowded with entries does not hold the others back.
+					size_t wanted = (size_t)options.threads * 4;
+					size_t chunk = length / wanted;
+					if (chunk < ParallelChunkSize) {
+						chunk = ParallelChunkSize;
+					}
+					int capacity = (int)(length / chunk) + 1;
+					ParallelPart* parts = new ParallelPart[capacity];
+					StructuralScanner scanner(content, length);
+					int count = 0;
+					size_t begin = 0;
+					while (begin < length && count < capacity) {
+						size_t end = length;
+						if (count + 1 < capacity && begin + chunk < length) {
+							end = NextHeaderLine(scanner, content, begin + chunk, length);
 						}
-						length++;
-						booleanIterator++;
+						ParallelPart& part = parts[count++];
+						part.content = content;
+						part.length = length;
+						part.begin = begin;
+						part.end = end;
+						part.options = &options;
+						begin = end;
 					}
-					if (resultLocation) {
-						char* phraseEndingCheckIterator = resultLocation;
-						byte TrailingSpacesButItsOk = 0;
-						bool correctEnding = false;
-						while (Char(*phraseEndingCheckIterator).IsLetter() &&
-							*phraseEndingCheckIterator != '#' &&
-							*phraseEndingCheckIterator != '-') {
-
-							if (*phraseEndingCheckIterator == '\n') {
-								correctEnding = true;
-								break;
-							}
-							else if (*phraseEndingCheckIterator == ' ') {
-								TrailingSpacesButItsOk++;
-							}
-							else {
-								output.Build(Kind::Bool, resultLocation, 6);
-								return { Sucess };
-							}
-							phraseEndingCheckIterator++;
+					TaskPool::Run(ParsePart, parts, count, options.threads);
+					for (int i = 0; i + 1 < count; i++) {
+						if (parts[i].reached > parts[i].end) {
+							// A multi-line array crossed the split, the next part started inside of it.
+							delete[] parts;
+							StructuralScanner serial(content, length);
+							ParseRange(serial, content, 0, length, builder, options, decoding, options.statistics);
+							return;
 						}
-
-						return { Sucess, TrailingSpacesButItsOk };
 					}
-					return NotValidTryNext;
+					uint64_t merging = options.statistics ? ParseClock::Nanoseconds() : 0;
+					for (int i = 0; i < count; i++) {
+						if (options.statistics) {
+							options.statistics->Merge(parts[i].statistics);
+						}
+						builder.Append(parts[i].builder);
+						if (decoding.StatusCode == Sucess && parts[i].decoding.StatusCode != Sucess) {
+							decoding = parts[i].decoding;
+						}
+					}
+					if (options.statistics) {
+						options.statistics->buildNanoseconds += ParseClock::Nanoseconds() - merging;
+					}
+					delete[] parts;
 				}
+			};
+
+			/// <summary>
+			/// Receiver of the events of a StreamParser. Tokens are only valid during the call.
+			/// </summary>
+			class StreamHandler {
+			public:
 				/// <summary>
-				/// Parses the valuable text (string) side of the equation.
+				/// A path header was read, entries that follow belong to it.
 				/// </summary>
-				/// <param name="startIndex">Reference index of the line, for the final token to be stored in output</param>
-				/// <param name="segmentIterator">Data accessor iterator starting after the equal symbol.</param>
-				/// <param name="output">Output structure space for storing resulting analysis if operation completes.</param>
-				/// <returns></returns>
-				static TOMLResultStatus ParseString(char* segmentIterator) {
-
-					char* stringInitialIterator = segmentIterator;
-					char* stringIterator = segmentIterator;
-					char* stringStart = nullptr;
-					char* stringEnd = nullptr;
+				virtual void OnPath(const TOMLToken& /*name*/) {}
+				/// <summary>
+				/// A key/value pair was read.
+				/// </summary>
+				/// <param name="path">Current path name, empty for the root path</param>
+				/// <param name="key">Key token</param>
+				/// <param name="kind">Kind of the value</param>
+				/// <param name="value">Trimmed value token</param>
+				virtual void OnEntry(const TOMLToken& /*path*/, const TOMLToken& /*key*/, Kind /*kind*/, const TOMLToken& /*value*/) {}
+				/// <summary>
+				/// A comment line was read.
+				/// </summary>
+				/// <param name="offset">Offset of the comment in the whole stream</param>
+				/// <param name="text">Comment text after the '#'</param>
+				virtual void OnComment(size_t /*offset*/, const TOMLToken& /*text*/) {}
+				virtual ~StreamHandler() {}
+			};
+			/// <summary>
+			/// Push parser for documents too large to be resident. The input is fed in arbitrary chunks
+			/// and every line is classified by Parser::ClassifyLine, like Parser::Parse does. Only the
+			/// line crossing the chunk boundary and the current path name are kept, so memory is bounded
+			/// by the longest line.
+			/// </summary>
+			class StreamParser {
+				StreamHandler* handler;
+				/// <summary>
+				/// Incomplete lines carried over from the previous chunk.
+				/// </summary>
+				char* carry = nullptr;
+				size_t carryLength = 0;
+				size_t carryCapacity = 0;
+				/// <summary>
+				/// Copy of the current path name, the chunk holding the header may be gone.
+				/// </summary>
+				char* path = nullptr;
+				int pathLength = 0;
+				size_t pathCapacity = 0;
+				/// <summary>
+				/// Stream offset of the first byte of the next chunk.
+				/// </summary>
+				size_t offset = 0;
+				/// <summary>
+				/// Stream offset of the carried line.
+				/// </summary>
+				size_t carryOffset = 0;
+				/// <summary>
+				/// The carried text starts with an array value not closed yet.
+				/// </summary>
+				bool carryOpen = false;
+				StreamParser(const StreamParser&);
+				StreamParser& operator=(const StreamParser&);
 
-					while (*stringIterator != '\n' && *stringIterator != '#' && *stringIterator != '\r') {
-						if (*stringIterator == '"' && stringStart == nullptr) {
-							stringStart = stringIterator + 1;
+				static void Reserve(char*& buffer, size_t length, size_t& capacity, size_t required) {
+					if (required <= capacity) {
+						return;
+					}
+					size_t grown = capacity ? capacity : 256;
+					while (grown < required) {
+						grown *= 2;
+					}
+					char* resized = new char[grown];
+					if (buffer) {
+						Marshal::Copy(buffer, resized, length);
+						delete[] buffer;
+					}
+					buffer = resized;
+					capacity = grown;
+				}
+				void Append(const char* data, size_t length) {
+					Reserve(carry, carryLength, carryCapacity, carryLength + length);
+					Marshal::Copy(data, carry + carryLength, length);
+					carryLength += length;
+				}
+				void Dispatch(const LineToken& token, char* content, size_t contentOffset) {
+					if (token.kind == Kind::Comment) {
+						handler->OnComment(contentOffset + (token.line.contents - content), token.value);
+					}
+					else if (token.kind == Kind::Path) {
+						Reserve(path, 0, pathCapacity, (size_t)token.name.length);
+						Marshal::Copy(token.name.contents, path, token.name.length);
+						pathLength = token.name.length;
+						handler->OnPath(token.name);
+					}
+					else {
+						TOMLToken current = { path, pathLength };
+						handler->OnEntry(current, token.name, token.kind, token.value);
+					}
+				}
+				/// <summary>
+				/// Dispatches the lines of content starting in [line, length).
+				/// </summary>
+				/// <param name="final">The content ends the stream, incomplete lines are dispatched as they are</param>
+				/// <returns>Offset of the first line the end of the content left incomplete, length if none</returns>
+				size_t Consume(StructuralScanner& scanner, char* content, size_t line, size_t length, size_t contentOffset, bool final) {
+					LineToken token;
+					carryOpen = false;
+					while (line < length) {
+						size_t lineEnd = scanner.Next(StructuralNewline, line, length);
+						if (lineEnd == length && !final) {
+							return line;
 						}
-						else if (*stringIterator == '"' && stringStart && stringEnd == nullptr) {
-							stringEnd = stringIterator;
+						bool classified = Parser::ClassifyLine(scanner, content, line, lineEnd, token);
+						if (classified && !final && (token.open || lineEnd == length)) {
+							carryOpen = token.open;
+							return line;
 						}
-						else if (*stringIterator == '"' && stringStart && stringEnd) {
-							return { UnexpectedToken, 0 };
+						if (classified) {
+							Dispatch(token, content, contentOffset);
+						}
+						line = lineEnd + 1;
+					}
+					return length;
+				}
+				/// <summary>
+				/// Dispatches what the carried text completes, keeping the rest carried.
+				/// </summary>
+				void ConsumeCarry(bool final) {
+					StructuralScanner scanner(carry, carryLength);
+					size_t rest = Consume(scanner, carry, 0, carryLength, carryOffset, final);
+					if (rest >= carryLength) {
+						carryLength = 0;
+					}
+					else if (rest > 0) {
+						memmove(carry, carry + rest, carryLength - rest);
+						carryLength -= rest;
+						carryOffset += rest;
+					}
+				}
+			public:
+				StreamParser(StreamHandler* handler) : handler(handler) {}
+				/// <summary>
+				/// Parses the complete lines of a chunk and keeps its trailing partial line, or the lines of
+				/// a multi-line array the chunk does not close.
+				/// </summary>
+				/// <param name="chunk">Chunk contents, only read during the call</param>
+				/// <param name="length">Chunk length</param>
+				/// <returns>True if sucess.</returns>
+				Boolean Feed(char* chunk, size_t length) {
+					if (!handler || (!chunk && length)) {
+						return false;
+					}
+					StructuralScanner scanner(chunk, length);
+					size_t base = offset;
+					size_t line = 0;
+					offset += length;
+					while (carryLength) {
+						// The carried text takes the chunk line by line until it completes.
+						size_t newline = scanner.Next(StructuralNewline, line, length);
+						size_t end = newline < length ? newline + 1 : length;
+						bool closing = scanner.Next(StructuralClose, line, end) < end;
+						Append(chunk + line, end - line);
+						line = end;
+						if (newline == length) {
+							return true;
+						}
+						if (!carryOpen || closing) {
+							ConsumeCarry(false);
 						}
+					}
+					size_t rest = Consume(scanner, chunk, line, length, base, false);
+					if (rest < length) {
+						carryOffset = base + rest;
+						Append(chunk + rest, length - rest);
+					}
+					return true;
+				}
+				/// <summary>
+				/// Parses the carried text, the last line or an array the stream did not close.
+				/// </summary>
+				Boolean Finish() {
+					if (!handler) {
+						return false;
+					}
+					if (carryLength) {
+						ConsumeCarry(true);
+						carryLength = 0;
+					}
+					return true;
+				}
+				/// <summary>
+				/// Releases the line buffers and restarts the stream.
+				/// </summary>
+				void Destroy() {
+					delete[] carry;
+					delete[] path;
+					carry = nullptr;
+					path = nullptr;
+					carryLength = carryCapacity = 0;
+					pathLength = 0;
+					pathCapacity = 0;
+					offset = carryOffset = 0;
+					carryOpen = false;
+				}
+				~StreamParser() {
+					Destroy();
+				}
+			};
 
-						stringIterator++;
+			/// <summary>
+			/// Current document of a configuration that is reloaded while other threads read it, with
+			/// epoch based reclamation. A reader claims a slot once with Register, then enters it around
+			/// each read: entering stores the published epoch in the slot and loads the document, a fixed
+			/// number of steps that never waits for a reloader. Publish swaps a new document in and
+			/// destroys the replaced ones once no slot entered before the swap is still inside.
+			/// Published documents are shared read-only, their lazy entries are resolved and their entry
+			/// views built before they become visible. Readers must not Patch or Reparse them.
+			/// </summary>
+			/// <example>
+			/// int slot = config.Register();
+			/// {
+			///     SharedDocument::Guard guard(config, slot);
+			///     Entry* port = guard->FindEntryByPath("server/port");
+			/// }
+			/// </example>
+			class SharedDocument {
+			public:
+				static const int MaxReaders = 64;
+				/// <summary>
+				/// Scoped read of the current document through a registered slot.
+				/// </summary>
+				class Guard {
+					SharedDocument& owner;
+					int slot;
+					TOML* document;
+				public:
+					Guard(SharedDocument& shared, int readerSlot) : owner(shared), slot(readerSlot) {
+						document = owner.Enter(slot);
 					}
-					if (stringStart && stringEnd) {
-						return { Sucess, stringEnd - stringStart };
+					~Guard() {
+						owner.Leave(slot);
+					}
+					/// <summary>
+					/// The document, nullable before the first Publish.
+					/// </summary>
+					TOML* Get() const {
+						return document;
+					}
+					TOML* operator->() const {
+						return document;
+					}
+				};
+			private:
+				/// <summary>
+				/// Reader slot, one per 128 bytes so readers on different threads do not share cache lines.
+				/// </summary>
+				struct Slot {
+					/// <summary>
+					/// Epoch the reader entered at, 0 while it is outside.
+					/// </summary>
+					volatile uint32_t epoch;
+					volatile int claimed;
+					char padding[120];
+				};
+				/// <summary>
+				/// Replaced document, destroyed once every slot is outside or entered at epoch or later.
+				/// </summary>
+				struct Retired {
+					TOML* document;
+					uint32_t epoch;
+					Retired* next;
+				};
+				Slot slots[MaxReaders];
+				TOML* volatile current = nullptr;
+				volatile uint32_t epoch = 1;
+				volatile int publishing = 0;
+				Retired* retired = nullptr;
+				SharedDocument(const SharedDocument&);
+				SharedDocument& operator=(const SharedDocument&);
+
+				static void Fence() {
+#if defined(TOML_THREADS)
+					__sync_synchronize();
+#endif
+				}
+				void Lock() {
+#if defined(TOML_THREADS)
+					while (__sync_lock_test_and_set(&publishing, 1)) {
+					}
+#endif
+				}
+				void Unlock() {
+#if defined(TOML_THREADS)
+					__sync_lock_release(&publishing);
+#endif
+				}
+				static void Release(TOML* document) {
+					if (document->Contents.NotNull()) {
+						document->Destroy();
 					}
-					return { TOMLResultStatusCode::NotValidTryNext, 0 };
+					delete document;
 				}
 				/// <summary>
-				/// Parses the valuable equation side of the equation.
+				/// Destroys the retired documents no reader can see anymore. Called with the publish lock held.
 				/// </summary>
-				static HResult ParseEquation(char* contents, Value& output, TOMLResultStatus* outputResult) {
-					// Paso 1: encontrar el smbolo de asignacin '='
-					char* iterator = contents;
-					bool foundAssignment = false;
-					while (*iterator != '\n' && *iterator != '\0') { // Displace until end of line or eof for finding assignment operator.
-						if (*iterator == '=') { // Operator has been found break and start analysis.
-							foundAssignment = true;
-							break;
+				void ReclaimRetired() {
+					uint32_t oldest = 0xFFFFFFFF;
+					for (int i = 0; i < MaxReaders; i++) {
+						uint32_t entered = slots[i].epoch;
+						if (entered && entered < oldest) {
+							oldest = entered;
 						}
-						iterator++;
 					}
-					if (foundAssignment) {
-						int length = 0;
-						iterator++; // Move to the next char ignoring the starting '='
-						while (*iterator == ' ') { // Displace for all initially trailling space.
-							iterator++;
+					Retired** link = &retired;
+					while (*link) {
+						Retired* node = *link;
+						if (node->epoch <= oldest) {
+							*link = node->next;
+							Release(node->document);
+							delete node;
 						}
-						int EOL_Offset = 0;
-						bool commentFound = false;
-						char* defaultValuableIterator = iterator;
-						char* commentIterator = iterator;
-						char* integerIterator = iterator;
-						char* booleanIterator = iterator;
-						char* decimalIterator = iterator;
-						/// TRY FIND COMMENTARY
-						while (*commentIterator && *commentIterator != '\n') {
-							if (*commentIterator == '#') {
-								commentFound = true;
-							}
-							commentIterator++;
-							EOL_Offset++;
+						else {
+							link = &node->next;
 						}
-						/// TRY TO PARSE THE VALUABLE SEGMENT INTO AN STRING
-						TOMLResultStatus stringAnalysis = ParseString(defaultValuableIterator);
-						*outputResult = stringAnalysis;
-						if (stringAnalysis.StatusCode == Sucess) {
-							/// IN THIS CASE, WE ASSIGNED ALREADY THE LENGTH OF THE RESULT INTO THE RESULT CODE. 
-							output.Build(Kind::String, defaultValuableIterator, stringAnalysis.Valuable);
-							return Sucess;
+					}
+				}
+			public:
+				SharedDocument() {
+					sys::memset((void*)slots, 0, sizeof(slots));
+				}
+				/// <summary>
+				/// Destroys the current and retired documents. No reader may be inside then.
+				/// </summary>
+				~SharedDocument() {
+					while (retired) {
+						Retired* node = retired;
+						retired = node->next;
+						Release(node->document);
+						delete node;
+					}
+					if (current) {
+						Release(current);
+					}
+				}
+				/// <summary>
+				/// Claims a reader slot, each thread reading concurrently needs its own.
+				/// </summary>
+				/// <returns>Slot index, -1 if all MaxReaders slots are taken</returns>
+				int Register() {
+					for (int i = 0; i < MaxReaders; i++) {
+#if defined(TOML_THREADS)
+						if (__sync_bool_compare_and_swap(&slots[i].claimed, 0, 1)) {
+							return i;
 						}
-						else {
-							TOMLResultStatus booleanAnalysis = ParseBoolean(booleanIterator, output);
-							*outputResult = booleanAnalysis;
-							if (booleanAnalysis.StatusCode == Sucess) {
-								return Sucess;
-							}
-							else {
-								TOMLResultStatus integralAnalysis = ParseNumeric(integerIterator, output);
-								*outputResult = integralAnalysis;
-								if (integralAnalysis.StatusCode == Sucess) {
-
-									return Sucess;
-								}
-								else {
-									TOMLResultStatus decimalAnalysis = ParseDecimal(decimalIterator, output);
-									*outputResult = decimalAnalysis;
-									if (decimalAnalysis.StatusCode == Sucess) {
-
-										return Sucess;
-									}
-									else {
-										return EUNEXPECTED;
-									}
-								}
-							}
+#else
+						if (!slots[i].claimed) {
+							slots[i].claimed = 1;
+							return i;
 						}
+#endif
 					}
-					else {
-						return EINVALID;
+					return -1;
+				}
+				/// <summary>
+				/// Gives a slot back, the reader must be outside.
+				/// </summary>
+				void Unregister(int slot) {
+					slots[slot].epoch = 0;
+					Fence();
+					slots[slot].claimed = 0;
+				}
+				/// <summary>
+				/// Starts a read, the returned document stays alive until Leave. Reads do not nest in a slot.
+				/// </summary>
+				/// <returns>The current document, nullable before the first Publish</returns>
+				TOML* Enter(int slot) {
+					slots[slot].epoch = epoch;
+					// Publish swaps before it advances the epoch: a reader whose slot the reclaim scan
+					// misses loads the document after the swap.
+					Fence();
+					return current;
+				}
+				void Leave(int slot) {
+					Fence();
+					slots[slot].epoch = 0;
+				}
+				/// <summary>
+				/// Makes the specified document current and takes ownership of it. The document must be
+				/// allocated with new and parsed, readers see it from their next Enter.
+				/// </summary>
+				void Publish(TOML* document) {
+					if (document && document->Contents.NotNull()) {
+						document->Contents->ResolveAll();
+						document->Contents->FillViews();
 					}
-
+					Lock();
+					Fence();
+					TOML* previous = current;
+					current = document;
+					Fence();
+					epoch = epoch + 1;
+					if (previous) {
+						Retired* node = new Retired;
+						node->document = previous;
+						node->epoch = epoch;
+						node->next = retired;
+						retired = node;
+					}
+					Fence();
+					ReclaimRetired();
+					Unlock();
 				}
 				/// <summary>
-				/// Tries to determine the kind of the TOML line, then stores the information into 'output'
-				/// using the provided index, length and line information.
+				/// Loads the specified file into a new document and publishes it. The current document is
+				/// kept when the file cannot be loaded or has a malformed value.
 				/// </summary>
-				/// <param name="ReferenceIndex">Character index of the current line</param>
-				/// <param name="line">The line section after the break</param>
-				/// <param name="lineLength">The length of the line until nullterminator or break</param>
-				/// <param name="output">Target resulting output</param>
-				/// <param name="outputStatus">Target resulting status</param>
-				/// <returns></returns>
-				static Kind ParseLine(char* line, size_t lineLength, Value& output, TOMLResultStatus* outputStatus) {
-					if (!line) {
-						return Kind::Unknown;
+				/// <param name="outputStatus">Nullable, see Parser::Parse</param>
+				/// <returns>True if the file was published</returns>
+				Boolean Load(const char* path, int flags, const ParseOptions& options, TOMLResultStatus* outputStatus) {
+					TOML* document = new TOML();
+					if (!document->LoadFile(path, flags, options, outputStatus)) {
+						Release(document);
+						return false;
 					}
-					while (*line == '#') {
-						output.kind = Kind::Comment;
-						output.token.contents = line;
-						output.token.length = Text::LineLength(line);
+					Publish(document);
+					return true;
+				}
+				Boolean Load(const char* path, int flags = 0) {
+					return Load(path, flags, ParseOptions(), nullptr);
+				}
+				/// <summary>
+				/// Destroys the replaced documents readers left since the last Publish.
+				/// </summary>
+				void Reclaim() {
+					Lock();
+					Fence();
+					ReclaimRetired();
+					Unlock();
+				}
+			};
 
-						return Kind::Comment;
-						break;
-					}
-					char* original = line;
-					char* iterator = line;
-					while (*iterator == ' ') {
-						iterator++;
+			/// <summary>
+			/// Documents loaded together, one TOML handle per source, in the order of the sources. The sources
+			/// are parsed on a TaskPool with ParseOptions::threads workers, each document by a single worker.
+			/// A worker claims the next source from a shared counter and stages every document it parses with
+			/// its own DocumentBuilder, whose chunks and path index are reused from one document to the next.
+			/// A worker maps the file of its next source before parsing the current one, with the kernel
+			/// asked to read it meanwhile, so reading a file overlaps with parsing the previous one.
+			/// Once the builders are warm, loading a document allocates three blocks: its TOML handle, its
+			/// Root and the storage block of the Root, which holds the indexes and the TableTree too. Like in
+			/// any document, the Entry views of EntryAt and FindEntryByPath are allocated on the first lookup.
+			/// </summary>
+			/// <example>
+			/// DocumentBatch tenants;
+			/// ParseOptions options;
+			/// options.threads = 8;
+			/// tenants.LoadFiles(paths, count, 0, options);
+			/// Entry* quota = tenants[i].FindEntryByPath("limits/quota");
+			/// </example>
+			class DocumentBatch {
+				struct Item {
+					TOML* document;
+					TOMLResultStatus status;
+					bool opened;
+					Item() : document(nullptr), status(Sucess), opened(false) {
 					}
-					if (*iterator == '[' && *(iterator + lineLength - 1) == ']') {
-						output.kind = Path;
-						output.token.contents = iterator + 1; 
-						output.token.length = lineLength - 1;
-						return output.kind;
+				};
+				struct Worker {
+					DocumentBuilder builder;
+					ParseStatistics statistics;
+				};
+				/// <summary>
+				/// State shared by the workers of one load, sources are files when paths is set.
+				/// </summary>
+				struct Job {
+					Item* items;
+					int count;
+					const char* const* paths;
+					char* const* buffers;
+					const size_t* lengths;
+					int flags;
+					ParseOptions options;
+					Worker* workers;
+					volatile int next;
+				};
+				Item* items = nullptr;
+				int count = 0;
+				DocumentBatch(const DocumentBatch&);
+				DocumentBatch& operator=(const DocumentBatch&);
+
+				static int Claim(Job* job) {
+#if defined(TOML_THREADS)
+					return __sync_fetch_and_add(&job->next, 1);
+#else
+					return job->next++;
+#endif
+				}
+				/// <summary>
+				/// Creates the document of a source and, for files, maps the file into it.
+				/// </summary>
+				static void Open(Job& job, int index) {
+					Item& item = job.items[index];
+					item.document = new TOML();
+					item.document->Contents.ConstructorInit();
+					if (job.paths) {
+						item.opened = job.paths[index] && item.document->Contents->Mapping.Open(job.paths[index], job.flags | MappedFile::WillNeed);
 					}
 					else {
-						HResult h = ParseEquation(line, output, outputStatus);
-						if (h == 1 || h == 0) {
-							return output.kind;
-						}
-						return Unknown;
+						item.opened = job.buffers[index] != nullptr;
+					}
+					if (!item.opened) {
+						item.status = TOMLResultStatus(PathNotFound);
 					}
-
 				}
-
-				static Kind GetKindForPairValueString(char* valueString) {
-					int length = Text::LineLength(valueString);
-					int index = 0;
-					while (*valueString == ' ') {
-						index++;
-						valueString++;
+				static void Load(Job& job, Worker& worker, int index) {
+					Item& item = job.items[index];
+					if (!item.opened) {
+						return;
 					}
-					if (safest_compare(valueString, BOOLEAN_FALSE_LITERAL) ||
-						safest_compare(valueString, BOOLEAN_TRUE_LITERAL)) {
-						return Kind::Bool;
+					static char empty[1] = { 0 };
+					Root& root = *item.document->Contents.operator->();
+					char* data;
+					size_t length;
+					if (job.paths) {
+						data = root.Mapping.getLength() ? root.Mapping.GetData() : empty;
+						length = root.Mapping.getLength();
 					}
 					else {
-						int letters_c = Text::countLettersInLine(valueString);
-						int numbers_c = Text::countNumbersInLine(valueString);
-						int spaces_c = Text::countSpacesInLine(valueString);
-						if (letters_c == 0 && numbers_c > 0) {
-							if (Text::couldBeIntegerRepresentation(valueString)) {
-								return Kind::Integer;
-							}
-							else if (Text::couldBeFloatValueRepresentation(valueString, '.')) {
-								return Kind::Double;
-							}
-						}
-						if (*valueString == '[') {
-							return Kind::Array;
+						data = job.buffers[index];
+						length = job.lengths[index];
+					}
+					root.SetData(data, length);
+					ParseStatistics document;
+					ParseOptions options = job.options;
+					options.statistics = job.options.statistics ? &document : nullptr;
+					Parser::Parse(data, length, item.document, options, &item.status, worker.builder);
+					if (options.statistics) {
+						worker.statistics.Merge(document);
+						worker.statistics.memory += document.memory;
+					}
+				}
+				static void Work(void* context, int index) {
+					Job& job = *(Job*)context;
+					Worker& worker = job.workers[index];
+					int current = Claim(&job);
+					if (current < job.count) {
+						Open(job, current);
+					}
+					while (current < job.count) {
+						int following = Claim(&job);
+						if (following < job.count) {
+							Open(job, following);
 						}
-						else {
-							char commaEnding = 0;
-							char commaStarting = 0;
-							int textEnd = 0;
-							int textStart = 0;
-							for (int i = length - 1; i > 0; i--) {
-								if (valueString[i] == '"') {
-									commaEnding = '"';
-									textEnd = i;
-									break;
-								}
-								else if (valueString[i] == '\'') {
-									commaEnding = '\'';
-									textEnd = i;
-									break;
-								}
-							}
-							for (int i = 0; i < length; i++) {
-								if (valueString[i] == '"') {
-									commaStarting = '"';
-									textStart = i;
-									break;
-								}
-								else if (valueString[i] == '\'') {
-									commaStarting = '\'';
-									textStart = i;
-									break;
-								}
-							}
-							if (commaEnding == commaStarting && (commaStarting > 0 && commaEnding > 0)) {
-								return Kind::String;
-							}
-							return Kind::Unknown;
+						Load(job, worker, current);
+						current = following;
+					}
+				}
+				Boolean Run(Job& job, const ParseOptions& options) {
+					Destroy();
+					count = job.count > 0 ? job.count : 0;
+					items = count ? new Item[count] : nullptr;
+					int workers = options.threads > 1 ? options.threads : 1;
+					if (workers > TaskPool::MaxWorkers) {
+						workers = TaskPool::MaxWorkers;
+					}
+					if (workers > count) {
+						workers = count ? count : 1;
+					}
+					job.items = items;
+					job.count = count;
+					job.options = options;
+					job.options.threads = 1;
+					job.workers = new Worker[workers];
+					job.next = 0;
+					TaskPool::Run(Work, &job, workers, workers);
+					if (options.statistics) {
+						options.statistics->Reset();
+						for (int i = 0; i < workers; i++) {
+							options.statistics->Merge(job.workers[i].statistics);
+							options.statistics->memory += job.workers[i].statistics.memory;
 						}
 					}
-
+					delete[] job.workers;
+					return getFailures() == 0;
 				}
-
-				static Boolean Parse(char* content, size_t content_length, TOML* toml) {
-					if (!content) {
+			public:
+				DocumentBatch() {
+				}
+				~DocumentBatch() {
+					Destroy();
+				}
+				/// <summary>
+				/// Maps and parses the specified files, replacing the documents of a previous load. Each document
+				/// keeps its file mapped until it is destroyed, as TOML::LoadFile does.
+				/// </summary>
+				/// <param name="paths">File paths, entries may be null</param>
+				/// <param name="count">Path count</param>
+				/// <param name="flags">Combination of MappedFile::Flags</param>
+				/// <param name="options">Parser behaviours, threads is the worker count of the whole batch and the
+				/// statistics, if set, add up every document</param>
+				/// <returns>True if every file was mapped and parsed without a value error</returns>
+				Boolean LoadFiles(const char* const* paths, int count, int flags, const ParseOptions& options) {
+					if (!paths && count > 0) {
 						return false;
 					}
-					Reader textReader{};
-					textReader.SetContent(content);
-					int iteratedLines = 0;
-					size_t length = 0;
-					PathName currentPath;
-					TOMLResultStatus statusLine(TOMLResultStatusCode::NullReference, 0);
-					
-					int paths_c = 0;
-					int comments_c = 0;
-					int entries_c = 0;
-
-					while (!textReader.IsEof()) {
-						char* current = textReader.Current();
-						size_t index = current - content;
-						while ((*(current + 1) == '\n' && (*current) == '\n') || (*(current + 1) == '\r' && (*current) == '\r')) {
-							current = textReader.NextLine(length);
-						}
-						while (*current == ' ') {
-							current++;
-						}
-
-						if (*current == '[') {
-							paths_c++;
-						}
-						else if (*current == '#') {
-							comments_c++;
-						}
-						else {
-							entries_c++;
-						}
-						textReader.NextLine(length);
+					Job job = { nullptr, count, paths, nullptr, nullptr, flags, options, nullptr, 0 };
+					return Run(job, options);
+				}
+				/// <summary>
+				/// Parses the specified buffers in place, replacing the documents of a previous load. The buffers
+				/// are borrowed, as by Parser::Parse, and must outlive the documents.
+				/// </summary>
+				/// <param name="buffers">Document texts, entries may be null</param>
+				/// <param name="lengths">Text lengths, the texts do not need to be null terminated</param>
+				/// <returns>True if every buffer was parsed without a value error</returns>
+				Boolean ParseBuffers(char* const* buffers, const size_t* lengths, int count, const ParseOptions& options) {
+					if ((!buffers || !lengths) && count > 0) {
+						return false;
 					}
-					toml->Contents->Initialize(paths_c, entries_c, comments_c);
-
-					textReader.Restart();
-
-
-					while (!textReader.IsEof()) {
-						char* current = textReader.Current();
-						size_t index = current - content;
-						while ((*(current + 1) == '\n' && (*current) == '\n') || (*(current + 1) == '\r' && (*current) == '\r')) {
-							currentPath.Build(); // clear current path.
-							current = textReader.NextLine(length);
-							iteratedLines++;
-						}
-						while (*current == ' ') {
-							current++;
-						}
-						if (*current == '#') {
-							char* commentIterator = current + 1;
-							int length2 = 0;
-							while (Char(*commentIterator).IsLetter() && *commentIterator != '\n' && *commentIterator != '\n') {
-								length2++;
-								commentIterator++;
+					Job job = { nullptr, count, nullptr, buffers, lengths, 0, options, nullptr, 0 };
+					return Run(job, options);
+				}
+				int getLength() const {
+					return count;
+				}
+				/// <summary>
+				/// Document of the specified source, nullable once released. Documents of sources that could
+				/// not be opened are empty.
+				/// </summary>
+				TOML* getDocument(int index) const {
+					return items[index].document;
+				}
+				TOML& operator [](int index) {
+					return *items[index].document;
+				}
+				/// <summary>
+				/// Outcome of the specified source: the status of Parser::Parse, or PathNotFound when the
+				/// file could not be mapped or the buffer was null.
+				/// </summary>
+				const TOMLResultStatus& getStatus(int index) const {
+					return items[index].status;
+				}
+				/// <summary>
+				/// Count of the sources that could not be opened or had a value error.
+				/// </summary>
+				int getFailures() const {
+					int failures = 0;
+					for (int i = 0; i < count; i++) {
+						failures += items[i].status.StatusCode != Sucess;
+					}
+					return failures;
+				}
+				/// <summary>
+				/// Gives up the ownership of a document, such as for SharedDocument::Publish. The document
+				/// was allocated with new, its owner destroys and deletes it.
+				/// </summary>
+				TOML* Release(int index) {
+					TOML* document = items[index].document;
+					items[index].document = nullptr;
+					return document;
+				}
+				/// <summary>
+				/// Destroys the documents still owned by the batch.
+				/// </summary>
+				void Destroy() {
+					for (int i = 0; i < count; i++) {
+						TOML* document = items[i].document;
+						if (document) {
+							if (document->Contents.NotNull()) {
+								document->Destroy();
 							}
-							toml->Contents->AddComment(current - content, length2);
+							delete document;
 						}
-						else if (*current == '[') {
-							currentPath.Build(current + 1);
-							toml->Contents->AddPath(currentPath);
-						}
-						else {
-							Value valuable;
-							
-							signed int keyIndex = Text::IndexOf(current, '=');
-							if (keyIndex != -1 && (keyIndex < 0xff)) {
-								char key_str[64];
-								char value_str[64];
-								if (Text::SplitLineByKey(current, '=', key_str, value_str)) {
-									Kind valueKind = GetKindForPairValueString(value_str);
-									toml->Contents->AddEntryAndPath(currentPath, valueKind, { current, Text::LineLength(current)});
-									__nop();
-								}
-								Marshal::Clear(key_str);
-								Marshal::Clear(value_str);
-							}
+					}
+					delete[] items;
+					items = nullptr;
+					count = 0;
+				}
+			};
 
-						}
-						textReader.NextLine(length);
+			inline void Root::Resolve(int index) const {
+				if (ReadOnly) {
+					return;
+				}
+				TOMLToken value = getValue(index);
+				Kind kind = Parser::ClassifyValue(value.contents, value.length);
+				if (Columns.Scalars) {
+					TOMLScalar scalar = TOMLScalar::None();
+					Parser::DecodeScalar(kind, value.contents, value.length, scalar);
+					Columns.Scalars[index] = scalar;
+				}
+				Columns.Kinds[index] = (uint8_t)kind;
+			}
+			inline Boolean TOML::LoadFile(const char* path, int flags) {
+				return LoadFile(path, flags, ParseOptions(), nullptr);
+			}
+			inline Boolean TOML::LoadFile(const char* path, int flags, const ParseOptions& options, TOMLResultStatus* outputStatus) {
+				if (!Contents.NotNull()) {
+					Contents.ConstructorInit();
+				}
+				if (!Contents->Mapping.Open(path, flags)) {
+					return false;
+				}
+				static char empty[1] = { 0 };
+				char* data = Contents->Mapping.getLength() ? Contents->Mapping.GetData() : empty;
+				Contents->SetData(data, Contents->Mapping.getLength());
+				return Parser::Parse(data, Contents->Mapping.getLength(), this, options, outputStatus);
+			}
+			inline Boolean TOML::LoadCached(const char* path, const char* snapshotPath, int flags) {
+				return LoadCached(path, snapshotPath, flags, ParseOptions(), nullptr);
+			}
+			inline Boolean TOML::LoadCached(const char* path, const char* snapshotPath, int flags, const ParseOptions& options, TOMLResultStatus* outputStatus) {
+				if (!Contents.NotNull()) {
+					Contents.ConstructorInit();
+				}
+				MappedFile source;
+				if (!source.Open(path, flags)) {
+					return false;
+				}
+				static char empty[1] = { 0 };
+				size_t length = source.getLength();
+				char* data = length ? source.GetData() : empty;
+				uint64_t hash = TOMLHash::Content(data, length);
+				MappedFile image;
+				if (snapshotPath && image.Open(snapshotPath, flags) &&
+					Snapshot::Attach(*Contents.operator->(), image.GetData(), image.getLength(), hash, length, options.eagerDecode, options.groupTables)) {
+					source.Close();
+					Contents->Mapping.Take(image);
+					if (outputStatus) {
+						*outputStatus = TOMLResultStatus(Sucess);
 					}
 					return true;
 				}
-
-			};
+				image.Close();
+				Contents->Mapping.Take(source);
+				Contents->SetData(data, length);
+				Boolean parsed = Parser::Parse(data, length, this, options, outputStatus);
+				if (parsed && snapshotPath) {
+					Snapshot::Save(*Contents.operator->(), hash, snapshotPath);
+				}
+				return parsed;
+			}
 		}
 	}
 	